@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Order.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace engine {
+
+/**
+ * @brief Trading phase of an instrument
+ */
+enum class TradingState : std::uint8_t {
+    CONTINUOUS,  // Orders match on arrival
+    AUCTION      // Volatility interruption: limit orders rest unmatched until the book is uncrossed
+};
+
+/**
+ * @brief Price bands that interrupt continuous trading
+ *
+ * Bands are fractions of a reference price; a band of 0 is off.
+ */
+struct CircuitBreakerConfig {
+    double staticBand = 0.0;   // Around the static reference: the last auction price, or else the first trade
+    double dynamicBand = 0.0;  // Around the last trade price
+    std::chrono::milliseconds interruption{0};  // Auction length before trading resumes by itself; 0 waits for a resume call
+};
+
+/**
+ * @brief Static and dynamic price bands of one book, kept as integer ticks
+ *
+ * The tighter of the two bands is folded into one [low, high] range whenever
+ * a reference price changes, so the check per fill is two integer compares.
+ * The dynamic reference is the last trade price and is moved forward after
+ * every fill with one multiply and divide; the static reference changes only
+ * at the first trade and after an auction.
+ *
+ * Not thread-safe; the book calls it under its lock.
+ */
+class CircuitBreaker {
+public:
+    /**
+     * @brief Set the bands, keeping the current reference prices
+     */
+    void configure(const CircuitBreakerConfig& config) {
+        staticPpm_ = toPpm(config.staticBand);
+        dynamicPpm_ = toPpm(config.dynamicBand);
+        interruption_ = config.interruption;
+        updateStaticBand();
+        updateDynamicBand();
+    }
+
+    /**
+     * @brief Check whether a trade may print at a price
+     */
+    bool allows(Order::PriceTicks price) const {
+        return price >= low_ && price <= high_;
+    }
+
+    /**
+     * @brief Move the dynamic reference to a trade's price
+     */
+    void onTrade(Order::PriceTicks price) {
+        if (staticReference_ == 0) {
+            setStaticReference(price);
+        }
+        dynamicReference_ = price;
+        updateDynamicBand();
+    }
+
+    /**
+     * @brief Reset both references, e.g. to an auction price
+     */
+    void setReference(Order::PriceTicks price) {
+        setStaticReference(price);
+        dynamicReference_ = price;
+        updateDynamicBand();
+    }
+
+    Order::PriceTicks getReference() const { return dynamicReference_; }
+    Order::PriceTicks getLow() const { return low_; }
+    Order::PriceTicks getHigh() const { return high_; }
+    std::chrono::milliseconds getInterruption() const { return interruption_; }
+
+private:
+    static constexpr std::int64_t kPartsPerMillion = 1000000;
+    static constexpr Order::PriceTicks kNoLimitLow = std::numeric_limits<Order::PriceTicks>::min();
+    static constexpr Order::PriceTicks kNoLimitHigh = std::numeric_limits<Order::PriceTicks>::max();
+
+    static std::int64_t toPpm(double band) {
+        return band > 0 ? static_cast<std::int64_t>(std::llround(band * kPartsPerMillion)) : 0;
+    }
+
+    static void bandAround(Order::PriceTicks reference, std::int64_t ppm,
+                           Order::PriceTicks& low, Order::PriceTicks& high) {
+        if (reference == 0 || ppm == 0) {
+            low = kNoLimitLow;
+            high = kNoLimitHigh;
+            return;
+        }
+        std::int64_t width = static_cast<std::int64_t>(reference) * ppm / kPartsPerMillion;
+        low = static_cast<Order::PriceTicks>(std::max<std::int64_t>(reference - width, kNoLimitLow));
+        high = static_cast<Order::PriceTicks>(std::min<std::int64_t>(reference + width, kNoLimitHigh));
+    }
+
+    void setStaticReference(Order::PriceTicks price) {
+        staticReference_ = price;
+        updateStaticBand();
+    }
+
+    void updateStaticBand() {
+        bandAround(staticReference_, staticPpm_, staticLow_, staticHigh_);
+    }
+
+    void updateDynamicBand() {
+        Order::PriceTicks dynamicLow, dynamicHigh;
+        bandAround(dynamicReference_, dynamicPpm_, dynamicLow, dynamicHigh);
+        low_ = std::max(staticLow_, dynamicLow);
+        high_ = std::min(staticHigh_, dynamicHigh);
+    }
+
+    std::int64_t staticPpm_ = 0;
+    std::int64_t dynamicPpm_ = 0;
+    std::chrono::milliseconds interruption_{0};
+    Order::PriceTicks staticReference_ = 0;
+    Order::PriceTicks dynamicReference_ = 0;
+    Order::PriceTicks staticLow_ = kNoLimitLow;
+    Order::PriceTicks staticHigh_ = kNoLimitHigh;
+    Order::PriceTicks low_ = kNoLimitLow;
+    Order::PriceTicks high_ = kNoLimitHigh;
+};
+
+} // namespace engine
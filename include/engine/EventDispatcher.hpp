@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Order.hpp"
+#include "Trade.hpp"
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace engine {
+
+/**
+ * @brief Compile-time list of engine event subscribers
+ * 
+ * Each subscriber is a plain class that implements any of
+ * 
+ *     void onTrade(const Trade& trade);
+ *     void onFill(const Fill& fill);          // Trade plus the accounts on both sides
+ *     void onOrderProcessed(const Order& order);
+ * 
+ * A subscriber that implements onFill receives each trade there instead of in
+ * onTrade. Events are delivered to the subscribers in list order with direct,
+ * non-virtual calls, so the compiler can inline the whole dispatch. Events a
+ * subscriber does not implement cost nothing.
+ * 
+ * @tparam Subscribers Subscriber types, each default-constructible
+ */
+template<typename... Subscribers>
+class EventDispatcher {
+public:
+    /**
+     * @brief Deliver a trade to every subscriber that handles fills or trades
+     */
+    void onFill(const Fill& fill) {
+        std::apply([&fill](auto&... subscriber) { (dispatchFill(subscriber, fill), ...); }, subscribers_);
+    }
+    
+    /**
+     * @brief Deliver a processed order to every subscriber that handles orders
+     */
+    void onOrderProcessed(const Order& order) {
+        std::apply([&order](auto&... subscriber) { (dispatchOrder(subscriber, order), ...); }, subscribers_);
+    }
+    
+    /**
+     * @brief Access a subscriber by type, e.g. to configure it
+     */
+    template<typename Subscriber>
+    Subscriber& get() { return std::get<Subscriber>(subscribers_); }
+    
+    template<typename Subscriber>
+    const Subscriber& get() const { return std::get<Subscriber>(subscribers_); }
+
+private:
+    template<typename T, typename = void>
+    struct HandlesTrades : std::false_type {};
+    
+    template<typename T>
+    struct HandlesTrades<T, std::void_t<decltype(std::declval<T&>().onTrade(std::declval<const Trade&>()))>>
+        : std::true_type {};
+    
+    template<typename T, typename = void>
+    struct HandlesFills : std::false_type {};
+    
+    template<typename T>
+    struct HandlesFills<T, std::void_t<decltype(std::declval<T&>().onFill(std::declval<const Fill&>()))>>
+        : std::true_type {};
+    
+    template<typename T, typename = void>
+    struct HandlesOrders : std::false_type {};
+    
+    template<typename T>
+    struct HandlesOrders<T, std::void_t<decltype(std::declval<T&>().onOrderProcessed(std::declval<const Order&>()))>>
+        : std::true_type {};
+    
+    template<typename Subscriber>
+    static void dispatchFill(Subscriber& subscriber, const Fill& fill) {
+        if constexpr (HandlesFills<Subscriber>::value) {
+            subscriber.onFill(fill);
+        } else if constexpr (HandlesTrades<Subscriber>::value) {
+            subscriber.onTrade(fill.trade);
+        }
+    }
+    
+    template<typename Subscriber>
+    static void dispatchOrder(Subscriber& subscriber, const Order& order) {
+        if constexpr (HandlesOrders<Subscriber>::value) {
+            subscriber.onOrderProcessed(order);
+        }
+    }
+    
+    std::tuple<Subscribers...> subscribers_;
+};
+
+} // namespace engine
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "Order.hpp"
+#include "Trade.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief Kind of event carried by the fan-out ring
+ */
+enum class EngineEventType : std::uint8_t {
+    TRADE,
+    ORDER_UPDATE
+};
+
+/**
+ * @brief State of an order after the engine processed it
+ */
+struct OrderUpdate {
+    Order::OrderId orderId;
+    Order::Quantity remainingQuantity;
+    Order::PriceTicks price;
+    Order::InstrumentId instrument;
+    OrderSide side;
+    OrderStatus status;
+};
+
+/**
+ * @brief Event published to fan-out subscribers: a trade with its accounts, or an order update
+ */
+struct EngineEvent {
+    EngineEventType type;
+    union {
+        Fill fill;
+        OrderUpdate order;
+    };
+
+    EngineEvent() : type(EngineEventType::ORDER_UPDATE), order{} {}
+    explicit EngineEvent(const Fill& f) : type(EngineEventType::TRADE), fill(f) {}
+    explicit EngineEvent(const OrderUpdate& o) : type(EngineEventType::ORDER_UPDATE), order(o) {}
+};
+
+/**
+ * @brief What happens when a subscriber falls a full ring behind the publishers
+ */
+enum class LagPolicy {
+    BLOCK,       // Publishers wait for the subscriber (back-pressure on the engine)
+    CONFLATE,    // The subscriber skips the events it missed and continues with recent ones
+    DISCONNECT   // The subscriber is dropped and its thread stops
+};
+
+/**
+ * @brief Delivery statistics of one fan-out subscriber
+ */
+struct FanOutSubscriberStats {
+    std::string name;
+    LagPolicy policy;
+    std::uint64_t delivered;     // Events handed to the subscriber
+    std::uint64_t skipped;       // Events missed because of conflation
+    std::uint64_t lag;           // Events published but not yet delivered
+    std::uint64_t maxLag;        // Largest lag seen by the subscriber
+    bool disconnected;
+};
+
+/**
+ * @brief Output ring that engine events are written to once and read by many subscribers
+ *
+ * Publishers (the engine's worker threads) claim a sequence number with one
+ * atomic add, write the event into its slot and publish it by storing the
+ * slot's sequence. Every subscriber reads the ring at its own cursor on its own
+ * thread, so a slow subscriber never delays the others. Only BLOCK subscribers
+ * hold publishers back; CONFLATE and DISCONNECT subscribers that are lapped
+ * detect it from the slot sequence and recover according to their policy.
+ */
+class FanOutRing {
+public:
+    using Handler = std::function<void(const EngineEvent&)>;
+
+    static constexpr std::size_t kDefaultCapacity = 1 << 16;
+
+    /**
+     * @brief Create a ring
+     *
+     * @param capacity Number of event slots (rounded up to a power of two)
+     */
+    explicit FanOutRing(std::size_t capacity = kDefaultCapacity);
+
+    /**
+     * @brief Stops the subscriber threads
+     */
+    ~FanOutRing();
+
+    /**
+     * @brief Add a subscriber; must be called before start()
+     *
+     * @param name Name reported in the statistics
+     * @param policy What to do when the subscriber falls a full ring behind
+     * @param handler Called on the subscriber's thread for every delivered event
+     */
+    void addSubscriber(const std::string& name, LagPolicy policy, Handler handler);
+
+    /**
+     * @brief Check whether any subscriber has been added
+     */
+    bool hasSubscribers() const { return !subscribers_.empty(); }
+
+    /**
+     * @brief Start one thread per subscriber
+     */
+    void start();
+
+    /**
+     * @brief Deliver everything already published, then stop the subscriber threads
+     *
+     * Publishing must have stopped before this is called.
+     */
+    void stop();
+
+    /**
+     * @brief Write an event to the ring
+     *
+     * Thread-safe; may wait only if a BLOCK subscriber is a full ring behind.
+     *
+     * @param event The event to publish
+     */
+    void publish(const EngineEvent& event) {
+        std::uint64_t sequence = claimed_.fetch_add(1, std::memory_order_relaxed);
+
+        // Do not lap a BLOCK subscriber
+        if (sequence >= gatingLimit_.load(std::memory_order_acquire)) {
+            waitForGatingSubscribers(sequence);
+        }
+
+        Slot& slot = slots_[sequence & mask_];
+        // Wait for the publisher of the previous lap to finish with this slot
+        std::uint64_t previous = sequence >= slots_.size() ? sequence - slots_.size() + 1 : 0;
+        while (slot.sequence.load(std::memory_order_acquire) != previous) {
+            std::this_thread::yield();
+        }
+
+        // Mark the slot as being written so lapped readers discard what they copy
+        slot.sequence.store(kWriting, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.event = event;
+        slot.sequence.store(sequence + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get delivery statistics for every subscriber
+     */
+    std::vector<FanOutSubscriberStats> getStats() const;
+
+    /**
+     * @brief Number of events published so far
+     */
+    std::uint64_t publishedEvents() const { return claimed_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Bytes held by the preallocated event slots
+     */
+    std::size_t memoryBytes() const { return slots_.size() * sizeof(Slot); }
+
+    // Delete copy constructor/assignment
+    FanOutRing(const FanOutRing&) = delete;
+    FanOutRing& operator=(const FanOutRing&) = delete;
+
+private:
+    static constexpr std::uint64_t kWriting = ~std::uint64_t{0};
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> sequence{0};  // Sequence + 1 of the event in the slot
+        EngineEvent event;
+    };
+
+    struct Subscriber {
+        std::string name;
+        LagPolicy policy;
+        Handler handler;
+        std::thread thread;
+        alignas(64) std::atomic<std::uint64_t> cursor{0};  // Next sequence to deliver
+        std::atomic<std::uint64_t> delivered{0};
+        std::atomic<std::uint64_t> skipped{0};
+        std::atomic<std::uint64_t> maxLag{0};
+        std::atomic<bool> disconnected{false};
+    };
+
+    void waitForGatingSubscribers(std::uint64_t sequence);
+    void recordLag(Subscriber& subscriber, std::uint64_t cursor);
+    void runSubscriber(Subscriber& subscriber);
+
+    std::vector<Slot> slots_;
+    const std::uint64_t mask_;
+    std::vector<std::unique_ptr<Subscriber>> subscribers_;
+    bool running_ = false;
+    std::atomic<bool> stopping_{false};
+
+    alignas(64) std::atomic<std::uint64_t> claimed_{0};
+    // Sequences below this limit cannot lap a BLOCK subscriber; refreshed when reached
+    alignas(64) std::atomic<std::uint64_t> gatingLimit_{0};
+};
+
+} // namespace engine
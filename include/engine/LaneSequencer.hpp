@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory_resource>
+#include <utility>
+
+namespace engine {
+
+/**
+ * @brief Two-lane FIFO that lets priority items overtake waiting normal items, up to a bound
+ *
+ * Cancels and quote pulls go into the priority lane and new orders into the
+ * normal lane. pop() takes from the priority lane first, but once
+ * maxPriorityRun priority items in a row have overtaken a waiting normal item,
+ * the next pop() takes that normal item. With a bound of 0 there is a single
+ * lane and items leave in arrival order.
+ *
+ * The caller picks the lane. An item that must not overtake a waiting one,
+ * such as a cancel for an order that is still waiting, goes to the normal lane.
+ *
+ * The order items leave in depends only on the sequence of push() and pop()
+ * calls, so the live ingress queue and the replayer, which both sequence
+ * through this class, apply the same rules. References to waiting items stay
+ * valid until the item is popped, so they can be kept in an index.
+ *
+ * Not thread-safe.
+ *
+ * @tparam T Item type
+ */
+template<typename T>
+class LaneSequencer {
+public:
+    /**
+     * @brief Create an empty sequencer
+     *
+     * @param maxPriorityRun Priority items that may overtake a waiting normal item in a row; 0 disables the lanes
+     * @param resource Resource the lanes allocate from
+     */
+    explicit LaneSequencer(std::size_t maxPriorityRun = 0,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxPriorityRun_(maxPriorityRun),
+          priority_(resource),
+          normal_(resource) {}
+
+    /**
+     * @brief Add an item at the back of its lane
+     *
+     * @return T& The item in the lane, valid until it is popped
+     */
+    T& push(T item, bool priority) {
+        std::pmr::deque<T>& lane = priority && maxPriorityRun_ > 0 ? priority_ : normal_;
+        lane.push_back(std::move(item));
+        return lane.back();
+    }
+
+    /**
+     * @brief Get the item pop() would take next; the sequencer must not be empty
+     */
+    T& next() {
+        return takePriority() ? priority_.front() : normal_.front();
+    }
+
+    /**
+     * @brief Take the next item; the sequencer must not be empty
+     */
+    T pop() {
+        bool priority = takePriority();
+        run_ = priority ? run_ + !normal_.empty() : 0;
+
+        std::pmr::deque<T>& lane = priority ? priority_ : normal_;
+        T item = std::move(lane.front());
+        lane.pop_front();
+        return item;
+    }
+
+    bool empty() const { return priority_.empty() && normal_.empty(); }
+    std::size_t size() const { return priority_.size() + normal_.size(); }
+    std::size_t priorityCount() const { return priority_.size(); }
+    std::size_t getMaxPriorityRun() const { return maxPriorityRun_; }
+
+private:
+    bool takePriority() const {
+        return !priority_.empty() && (normal_.empty() || run_ < maxPriorityRun_);
+    }
+
+    std::size_t maxPriorityRun_;
+    std::size_t run_ = 0;  // Priority items taken in a row while a normal item waited
+    std::pmr::deque<T> priority_;
+    std::pmr::deque<T> normal_;
+};
+
+} // namespace engine
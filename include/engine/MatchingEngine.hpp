@@ -2,6 +2,14 @@
 
 #include "OrderBook.hpp"
 #include "OrderQueue.hpp"
+#include "EventDispatcher.hpp"
+#include "OrderPipeline.hpp"
+#include "OrderJournal.hpp"
+#include "Subscribers.hpp"
+#include "PositionKeeper.hpp"
+#include "TradeStore.hpp"
+#include "OrderValidator.hpp"
+#include "TradingHalts.hpp"
 #include <unordered_map>
 #include <string>
 #include <thread>
@@ -9,9 +17,44 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <condition_variable>
 
 namespace engine {
 
+/**
+ * @brief Configuration for the matching engine
+ */
+struct MatchingEngineConfig {
+    size_t numWorkers = 1;   // Number of worker threads to process orders
+    size_t numBooks = 1;     // Number of order books, one per instrument ID [0, numBooks)
+    bool logTrades = true;   // Print every executed trade to stdout
+    bool useArenas = true;   // Give each book and the ingress queue its own memory arena
+    util::HugePageMode hugePages = util::HugePageMode::NONE;  // Back the arenas with huge pages
+    bool warmUp = false;           // Pre-fault memory and exercise the match paths in start()
+    size_t warmUpOrders = 100000;  // Book depth to pre-fault for, per book
+    size_t fanOutCapacity = FanOutRing::kDefaultCapacity;  // Event slots in the fan-out ring
+    bool pipeline = false;         // Run risk, journal, match and publish as pipeline stages instead of workers
+    size_t pipelineCapacity = 1 << 16;  // Order slots in the pipeline ring
+    std::string journalPath;       // Journal file written by the pipeline; empty disables journaling
+    bool pinPipelineStages = false;     // Pin each pipeline stage to its own CPU
+    bool riskChecks = false;       // Run pre-trade risk checks on the submitting threads
+    size_t numAccounts = 1024;     // Accounts [0, numAccounts) known to risk checks and position keeping
+    RiskLimits riskLimits;         // Limits applied to every account
+    bool trackPositions = false;   // Keep per-account positions and P&L from the fill stream
+    std::string tradeStorePath;    // Trade store file every fill is written to; empty disables it
+    CircuitBreakerConfig circuitBreakers;  // Price bands applied to every book; all off by default
+    std::vector<InstrumentSpec> instruments;  // Reference data and tick tables per instrument ID; books without an entry use the defaults
+    size_t cancelPriorityRun = 0;  // Queued cancels that may overtake a waiting new order in a row; 0 keeps arrival order
+};
+
+/**
+ * @brief Subscribers notified of engine events, fixed at build time
+ * 
+ * Add a subscriber type here to have it called directly from the match path.
+ */
+using EngineEventDispatcher = EventDispatcher<RiskSubscriber, TradeLogSubscriber, FanOutPublisher, CallbackSubscriber>;
+
 /**
  * @brief Statistics for the matching engine
  */
@@ -19,6 +62,9 @@ struct MatchingEngineStats {
     std::atomic<uint64_t> totalOrdersProcessed{0};
     std::atomic<uint64_t> totalTradesExecuted{0};
     std::atomic<uint64_t> totalQuantityTraded{0};
+    std::atomic<uint64_t> totalCancelsProcessed{0};  // Queued cancels and reductions, applied or not
+    std::atomic<uint64_t> totalCancelsMissed{0};     // Of those, the ones whose order was not resting
+    std::atomic<uint64_t> totalCancelsCoalesced{0};  // Of those, the ones applied in the queue without reaching a book
 };
 
 /**
@@ -35,6 +81,13 @@ public:
      */
     explicit MatchingEngine(size_t numWorkers = 1);
     
+    /**
+     * @brief Construct a new Matching Engine from a configuration
+     * 
+     * @param config Engine configuration
+     */
+    explicit MatchingEngine(const MatchingEngineConfig& config);
+    
     /**
      * @brief Destructor - ensures clean shutdown of worker threads
      */
@@ -42,6 +95,14 @@ public:
     
     /**
      * @brief Start the matching engine
+     * 
+     * With MatchingEngineConfig::pipeline set, the pipeline stage threads are
+     * started instead of the worker pool.
+     * 
+     * With MatchingEngineConfig::warmUp set, the books, queue and huge-page regions
+     * are pre-faulted and a synthetic flow is run through every book before the
+     * workers start, so the first real orders do not pay for page faults and cold
+     * code paths. The books are empty again when start() returns.
      */
     void start();
     
@@ -56,14 +117,98 @@ public:
      * Thread-safe method that enqueues an order for processing.
      * Does not block unless the queue is very large.
      * 
+     * Every order is first validated against its instrument's reference data
+     * (MatchingEngineConfig::instruments), unless its instrument or account is
+     * halted. With MatchingEngineConfig::riskChecks
+     * set, the pre-trade checks run next. Both run here, on the calling thread,
+     * and a failing order is marked REJECTED and never queued. With
+     * MatchingEngineConfig::pipeline set, the pre-trade checks run in the
+     * pipeline's risk stage instead, so a risk reject is only visible on the
+     * order once it has been processed.
+     * 
      * @param order The order to submit
+     * @return true if the order was queued, false if a halt, validation or the gateway risk checks rejected it
+     */
+    bool submitOrder(std::shared_ptr<Order> order);
+    
+    /**
+     * @brief Submit a contiguous batch of orders, e.g. everything decoded from one gateway packet
+     * 
+     * Each order is checked as in submitOrder(), and the admitted ones are
+     * queued together: one lock acquisition and one notification for the
+     * worker queue, or one atomic slot claim for the pipeline, so the ingress
+     * cost grows with the number of batches rather than orders. The admitted
+     * orders keep their relative order and are not interleaved with orders
+     * from other threads.
+     * 
+     * @param orders First order of the batch
+     * @param count Number of orders
+     * @return size_t Number of orders queued; the others are marked REJECTED
+     * @throws std::out_of_range if any order's instrument has no book; nothing is queued then
+     */
+    std::size_t submitOrders(const std::shared_ptr<Order>* orders, std::size_t count);
+    
+    /**
+     * @brief Submit a batch of orders; see submitOrders(const std::shared_ptr<Order>*, std::size_t)
+     */
+    std::size_t submitOrders(const std::vector<std::shared_ptr<Order>>& orders) {
+        return submitOrders(orders.data(), orders.size());
+    }
+    
+    /**
+     * @brief Submit a cancel for a resting order
+     * 
+     * Thread-safe. The cancel is queued like an order and applied by a worker;
+     * with MatchingEngineConfig::cancelPriorityRun set, it waits in a lane of
+     * its own and is taken ahead of new orders queued before it, so in a burst
+     * it reaches the book before the aggressors that would hit the order.
+     * With MatchingEngineConfig::pipeline set, the cancel takes a ring slot and
+     * is applied by the match stage in submission order, after every order
+     * submitted before it; cancelPriorityRun and coalescing do not apply there.
+     * 
+     * If the order itself is still queued, the cancel annuls it there and
+     * neither reaches the book. A cancel for an order that already has a
+     * cancel or reduction queued is folded into that request. With several
+     * workers, an order that one worker has just taken can still rest after
+     * another worker applied its cancel.
+     * 
+     * The canceled order is passed to the order callback and the fan-out
+     * subscribers; MatchingEngineStats counts cancels that missed or were
+     * coalesced.
+     * 
+     * @param orderId ID of the order to cancel
+     * @param instrument Instrument the order rests on
+     * @throws std::out_of_range if the instrument has no book
+     */
+    void submitCancel(Order::OrderId orderId, Order::InstrumentId instrument = 0);
+    
+    /**
+     * @brief Submit a reduction of a resting order; queued and prioritized like submitCancel()
+     * 
+     * An order that is still queued is reduced in the queue, and repeated
+     * reductions of a resting order collapse into the one that is still queued.
+     * 
+     * @param orderId ID of the order to reduce
+     * @param quantity Quantity to take off the order
+     * @param instrument Instrument the order rests on
+     * @throws std::out_of_range if the instrument has no book
      */
-    void submitOrder(std::shared_ptr<Order> order);
+    void submitReduce(Order::OrderId orderId, Order::Quantity quantity, Order::InstrumentId instrument = 0);
+    
+    /**
+     * @brief Block until every order submitted so far has been processed
+     * 
+     * Completion barrier for callers that need to know when the queue has
+     * been fully worked off, e.g. to stop a benchmark timer.
+     */
+    void waitForCompletion();
     
     /**
      * @brief Process an order immediately (bypassing the queue)
      * 
-     * This is a thread-safe method that directly processes an order.
+     * This is a thread-safe method that directly processes an order. Validation
+     * and, when configured, risk checks apply here too; a rejected order produces
+     * no trades and is left REJECTED.
      * 
      * @param order The order to process
      * @return std::vector<Trade> Resulting trades
@@ -71,13 +216,156 @@ public:
     std::vector<Trade> processOrderSync(std::shared_ptr<Order> order);
     
     /**
-     * @brief Get the order book
+     * @brief Cancel a resting order immediately (bypassing the queue)
+     * 
+     * This is a thread-safe method.
+     * 
+     * @param orderId ID of the order to cancel
+     * @param instrument Instrument the order rests on
+     * @return true if the order was found and canceled
+     */
+    bool cancelOrderSync(Order::OrderId orderId, Order::InstrumentId instrument = 0);
+    
+    /**
+     * @brief Reduce a resting order immediately (bypassing the queue)
+     * 
+     * This is a thread-safe method.
+     * 
+     * @param orderId ID of the order to reduce
+     * @param quantity Quantity to take off the order
+     * @param instrument Instrument the order rests on
+     * @return true if the order was found and reduced
+     */
+    bool reduceOrderSync(Order::OrderId orderId, Order::Quantity quantity, Order::InstrumentId instrument = 0);
+    
+    /**
+     * @brief End a volatility interruption on an instrument with a single-price auction
+     * 
+     * This is a thread-safe method. The auction trades are dispatched like any
+     * other fills. Books also resume by themselves on the next order once
+     * CircuitBreakerConfig::interruption has passed.
+     * 
+     * An instrument halted with haltInstrument() is not uncrossed; it produces
+     * no trades until it is resumed with resumeInstrument().
+     * 
+     * @param instrument Instrument to resume
+     * @return std::vector<Trade> The auction trades
+     */
+    std::vector<Trade> resumeTrading(Order::InstrumentId instrument);
+    
+    /**
+     * @brief Get the trading phase of an instrument; lock-free
+     */
+    TradingState getTradingState(Order::InstrumentId instrument) const {
+        return bookFor(instrument).getTradingState();
+    }
+    
+    /**
+     * @brief Halt an instrument: its book takes no new orders until resumeInstrument()
+     * 
+     * Thread-safe and lock-free, meant for an admin thread. The halt applies from
+     * the next order to reach the book, including orders submitted before the call
+     * and still queued; those are left REJECTED and their risk is released. Resting
+     * orders stay in the book and can still be canceled or reduced.
+     * 
+     * @throws std::out_of_range if the instrument has no book
+     */
+    void haltInstrument(Order::InstrumentId instrument);
+    
+    /**
+     * @brief Lift an instrument halt; an interrupted book is uncrossed by the next order as usual
+     * 
+     * @throws std::out_of_range if the instrument has no book
+     */
+    void resumeInstrument(Order::InstrumentId instrument);
+    
+    /**
+     * @brief Halt an account: its new orders are rejected on every instrument until resumeAccount()
+     * 
+     * Thread-safe and lock-free; applies to queued orders like haltInstrument().
+     * The account's resting orders are left alone; see killAccount().
+     * 
+     * @throws std::out_of_range if the account is not below MatchingEngineConfig::numAccounts
+     */
+    void haltAccount(Order::AccountId account);
+    
+    /**
+     * @brief Lift an account halt
+     * 
+     * @throws std::out_of_range if the account is not below MatchingEngineConfig::numAccounts
+     */
+    void resumeAccount(Order::AccountId account);
+    
+    /**
+     * @brief Kill switch: halt an account and cancel its resting orders on every book
+     * 
+     * Thread-safe. The halt is set before the books are swept, and orders are
+     * checked against it under their book's lock, so an order either enters
+     * its book before the sweep and is canceled by it, or is rejected after
+     * it. No order of the account rests once this returns. The account stays
+     * halted until resumeAccount().
+     * 
+     * @return size_t Number of resting orders canceled
+     * @throws std::out_of_range if the account is not below MatchingEngineConfig::numAccounts
+     */
+    size_t killAccount(Order::AccountId account);
+    
+    /**
+     * @brief Get the halt flags and the count of orders they turned away
+     */
+    const TradingHalts& getTradingHalts() const { return halts_; }
+    
+    /**
+     * @brief Get the order book for an instrument
      * 
      * Thread-safe method.
      * 
+     * @param instrument Instrument ID (default: the first book)
      * @return const OrderBook& Reference to the order book
+     * @throws std::out_of_range if the instrument has no book
+     */
+    const OrderBook& getOrderBook(Order::InstrumentId instrument = 0) const;
+    
+    /**
+     * @brief Get the number of order books
+     */
+    size_t getNumBooks() const { return orderBooks_.size(); }
+    
+    /**
+     * @brief Get the validator that checks orders against instrument reference data
+     */
+    const OrderValidator& getValidator() const { return validator_; }
+    
+    /**
+     * @brief Get the pre-trade risk engine
+     * 
+     * @return Null unless the engine runs with MatchingEngineConfig::riskChecks
+     */
+    const RiskEngine* getRiskEngine() const { return risk_.get(); }
+    
+    /**
+     * @brief Get the journal written by the pipeline, with its written and lost record counts
+     * 
+     * @return Null unless the engine runs with MatchingEngineConfig::pipeline and a journalPath
+     */
+    const OrderJournal* getOrderJournal() const { return journal_.get(); }
+    
+    /**
+     * @brief Get the per-account positions and P&L
+     * 
+     * The keeper is updated by a fan-out subscriber thread, off the match path,
+     * and can be read while the engine runs.
+     * 
+     * @return Null unless the engine runs with MatchingEngineConfig::trackPositions
      */
-    const OrderBook& getOrderBook() const;
+    const PositionKeeper* getPositionKeeper() const { return positions_.get(); }
+    
+    /**
+     * @brief Get the trade store writer, with its written and lost record counts
+     * 
+     * @return Null unless MatchingEngineConfig::tradeStorePath is set
+     */
+    const TradeStoreWriter* getTradeStore() const { return tradeStore_.get(); }
     
     /**
      * @brief Get the current statistics
@@ -86,23 +374,148 @@ public:
      */
     const MatchingEngineStats& getStats() const { return stats_; }
     
+    /**
+     * @brief Get the memory held by all books, the ingress queue and the engine's rings and buffers
+     * 
+     * Thread-safe method. O(n) in resting orders; see OrderBook::getMemoryUsage.
+     * 
+     * @return MemoryUsage Memory by category
+     */
+    MemoryUsage getMemoryUsage() const;
+    
     /**
      * @brief Register a callback for trade notifications
      * 
      * @param callback The callback function to register
      */
     void registerTradeCallback(std::function<void(const Trade&)> callback) {
-        tradeCallback_ = callback;
+        dispatcher_.get<CallbackSubscriber>().tradeCallback = std::move(callback);
+    }
+    
+    /**
+     * @brief Add a subscriber that reads trades and order updates from the fan-out ring
+     * 
+     * Each subscriber gets its own thread and cursor, so a slow subscriber does not
+     * delay the engine or the other subscribers unless its policy is BLOCK.
+     * Must be called before the engine is started.
+     * 
+     * @param name Name reported in the statistics
+     * @param policy What to do when the subscriber falls a full ring behind
+     * @param handler Called on the subscriber's thread for every delivered event
+     */
+    void addEventSubscriber(const std::string& name, LagPolicy policy, FanOutRing::Handler handler);
+    
+    /**
+     * @brief Get delivery statistics, including lag, for every fan-out subscriber
+     */
+    std::vector<FanOutSubscriberStats> getEventSubscriberStats() const;
+    
+    /**
+     * @brief Get processed-order and batch counts per pipeline stage
+     * 
+     * @return Empty unless the engine runs with MatchingEngineConfig::pipeline
+     */
+    std::vector<PipelineStageStats> getPipelineStats() const;
+    
+    /**
+     * @brief Register a callback invoked by a worker once a queued order has been processed
+     * 
+     * Must be registered before the engine is started.
+     * 
+     * @param callback The callback function to register
+     */
+    void registerOrderCallback(std::function<void(const Order&)> callback) {
+        dispatcher_.get<CallbackSubscriber>().orderCallback = std::move(callback);
     }
     
 private:
-    OrderBook orderBook_;
+    // One huge-page region source per book plus one for the queue; declared first so it outlives them
+    std::vector<std::unique_ptr<util::HugePageResource>> pageResources_;
+    std::vector<std::unique_ptr<OrderBook>> orderBooks_;
     OrderQueue orderQueue_;
     std::vector<std::thread> workerThreads_;
     std::atomic<bool> running_{false};
     size_t numWorkers_;
+    bool warmUp_;
+    size_t warmUpOrders_;
+    CircuitBreakerConfig circuitBreakers_;
     MatchingEngineStats stats_;
-    std::function<void(const Trade&)> tradeCallback_;
+    EngineEventDispatcher dispatcher_;
+    size_t fanOutCapacity_;
+    std::unique_ptr<FanOutRing> fanOut_;  // Created with the first fan-out subscriber
+    OrderValidator validator_;
+    TradingHalts halts_;
+    std::unique_ptr<RiskEngine> risk_;
+    std::unique_ptr<PositionKeeper> positions_;
+    std::unique_ptr<TradeStoreWriter> tradeStore_;
+    
+    // Staged pipeline, used instead of the queue and workers when configured
+    struct PipelineStages;
+    std::unique_ptr<OrderJournal> journal_;
+    std::unique_ptr<OrderPipeline<PipelineStages>> pipeline_;
+    
+    // Completion barrier state
+    std::atomic<uint64_t> ordersSubmitted_{0};
+    std::atomic<uint64_t> ordersCompleted_{0};
+    std::atomic<int> completionWaiters_{0};
+    std::mutex completionMutex_;
+    std::condition_variable completionCv_;
+    
+    /**
+     * @brief Pre-fault memory and warm the match paths, then reset the books
+     */
+    void runWarmUp();
+    
+    /**
+     * @brief Get the book for an instrument
+     * 
+     * @throws std::out_of_range if the instrument has no book
+     */
+    OrderBook& bookFor(Order::InstrumentId instrument) const;
+    
+    /**
+     * @brief Validate an order and run the risk checks, rejecting it on failure
+     * 
+     * @param checkRisk Run the risk checks here; false when the pipeline's risk stage runs them
+     * @return true if the order may go to its book
+     */
+    bool admitOrder(Order& order, bool checkRisk = true);
+    
+    /**
+     * @brief Predicate for OrderBook::addOrder that turns away orders of a halted instrument or account
+     */
+    auto haltCheck() const {
+        return [this](const Order& order) { return halts_.blocks(order); };
+    }
+    
+    /**
+     * @brief Release the risk of an admitted order a halt stopped at its book
+     */
+    void releaseHalted(const Order& order);
+    
+    /**
+     * @brief Queue a cancel or reduction, or put it into the pipeline when one runs
+     */
+    void submitCancelRequest(const OrderRequest& request);
+    
+    /**
+     * @brief Apply a queued cancel or reduction and report the order
+     */
+    void executeCancel(const OrderRequest& request);
+    
+    /**
+     * @brief Apply a cancel or reduction to its book
+     * 
+     * @return The order it was applied to, or null if the order was not resting
+     */
+    std::shared_ptr<Order> applyCancel(const OrderRequest& request);
+    
+    /**
+     * @brief Count a cancel or reduction and report the order it was applied to
+     * 
+     * @param order The order, or null if the cancel missed
+     */
+    void reportCancel(const Order* order);
     
     /**
      * @brief Worker thread function that processes orders from the queue
@@ -110,11 +523,27 @@ private:
     void workerFunction();
     
     /**
-     * @brief Internal callback for trade notifications
+     * @brief Match an order that has passed the risk checks and dispatch its fills
+     */
+    std::vector<Trade> executeOrder(const std::shared_ptr<Order>& order);
+    
+    /**
+     * @brief Uncross a book and release the risk its auction trades used
      * 
-     * @param trade The trade that occurred
+     * @param onFill Called for every auction fill; the caller dispatches them
+     */
+    template<typename FillSink>
+    std::vector<Trade> uncrossBook(OrderBook& book, FillSink&& onFill);
+    
+    /**
+     * @brief Update statistics for a processed order and its trades
+     */
+    void recordProcessed(size_t tradeCount, Order::Quantity quantityTraded);
+    
+    /**
+     * @brief Count a queued order as done and wake anyone on the completion barrier
      */
-    void onTrade(const Trade& trade);
+    void completeOrder();
 };
 
 } // namespace engine
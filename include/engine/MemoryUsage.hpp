@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Order.hpp"
+#include <cstddef>
+#include <memory>
+
+namespace engine {
+
+/**
+ * @brief Live memory held by the engine, broken down by category
+ * 
+ * Byte counts are computed from the element counts of each container and the
+ * node layout of the standard containers in use, so they describe what the
+ * data structures need rather than what the allocator rounded them up to.
+ * Compare against process RSS to see allocator overhead.
+ */
+struct MemoryUsage {
+    size_t orderBytes = 0;     // Order objects with their shared_ptr control blocks
+    size_t priorityTreeBytes = 0;  // Price-time priority tree nodes for both sides of the book, one per resting order
+    size_t indexBytes = 0;     // Order ID index nodes
+    size_t queueBytes = 0;     // Ingress queue slots and the orders waiting in them
+    size_t arenaBytes = 0;     // Memory reserved by per-book and queue arenas (backs the trees, index and queue slots)
+    size_t hugePageBytes = 0;  // Regions mapped on explicit or transparent huge pages to back the arenas
+    size_t bufferBytes = 0;    // Preallocated rings and I/O buffers: pipeline slots, fan-out ring, journal and trade store
+    
+    size_t restingOrders = 0;
+    size_t priceLevels = 0;    // Distinct prices across both sides
+    size_t queuedOrders = 0;
+    
+    size_t totalBytes() const { return orderBytes + priorityTreeBytes + indexBytes + queueBytes + bufferBytes; }
+    
+    double bytesPerRestingOrder() const {
+        return restingOrders > 0 ? static_cast<double>(orderBytes + priorityTreeBytes + indexBytes) / restingOrders : 0.0;
+    }
+    
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        orderBytes += other.orderBytes;
+        priorityTreeBytes += other.priorityTreeBytes;
+        indexBytes += other.indexBytes;
+        queueBytes += other.queueBytes;
+        arenaBytes += other.arenaBytes;
+        hugePageBytes += other.hugePageBytes;
+        bufferBytes += other.bufferBytes;
+        restingOrders += other.restingOrders;
+        priceLevels += other.priceLevels;
+        queuedOrders += other.queuedOrders;
+        return *this;
+    }
+};
+
+namespace memory {
+
+// Red-black tree node header used by std::set/std::map: color plus parent/left/right links
+constexpr size_t kTreeNodeHeaderBytes = 4 * sizeof(void*);
+
+// Control block of std::make_shared: vtable pointer plus use and weak counts, with the object inline
+constexpr size_t kSharedOrderBytes = sizeof(void*) + 2 * sizeof(int) + sizeof(Order);
+
+/**
+ * @brief Bytes of one tree node holding a value of the given size
+ */
+constexpr size_t treeNodeBytes(size_t valueBytes) {
+    return kTreeNodeHeaderBytes + valueBytes;
+}
+
+} // namespace memory
+
+} // namespace engine
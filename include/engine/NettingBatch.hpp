@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Order.hpp"
+#include "TradeStore.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief Net obligation between two accounts in one instrument
+ *
+ * The pair is ordered so that firstAccount < secondAccount.
+ */
+struct NetObligation {
+    Order::InstrumentId instrument;
+    Order::AccountId firstAccount;
+    Order::AccountId secondAccount;
+    std::int64_t netQuantity;       // Delivered by the second account to the first; negative the other way
+    double netCash;                 // Paid by the first account to the second; negative the other way
+    Order::Quantity grossQuantity;  // Quantity traded between the two, both directions
+    std::uint64_t trades;
+};
+
+/**
+ * @brief Counters from the last netting run
+ */
+struct NettingStats {
+    std::uint64_t trades = 0;        // Records read
+    std::uint64_t selfTrades = 0;    // Trades with the same account on both sides; they net to nothing
+    std::uint64_t obligations = 0;   // Account pairs per instrument with at least one trade
+    std::size_t threads = 0;
+    std::size_t partitions = 0;
+    double elapsedMilliseconds = 0.0;
+};
+
+/**
+ * @brief End-of-day netting of a trade store into obligations per account pair and instrument
+ *
+ * Runs in two parallel phases on a pool of threads:
+ *
+ * 1. Each thread scans a contiguous slice of the records and aggregates it
+ *    into its own hash tables, one per instrument partition.
+ * 2. Each partition's tables from all threads are merged by one thread.
+ *
+ * No table is shared between threads, so neither phase takes a lock. The
+ * tables use open addressing with linear probing over flat arrays of 48-byte
+ * entries, so an update is a hash, usually one cache line, and no allocation.
+ * Amounts are summed as integer ticks, so the result does not depend on the
+ * number of threads.
+ */
+class NettingBatch {
+public:
+    /**
+     * @brief Create a batch job
+     *
+     * @param numThreads Threads in the pool (0 for one per hardware thread)
+     */
+    explicit NettingBatch(std::size_t numThreads = 0);
+
+    /**
+     * @brief Net an array of trade store records
+     *
+     * @return Obligations sorted by instrument, then account pair
+     */
+    std::vector<NetObligation> run(const TradeStoreRecord* records, std::size_t count);
+
+    /**
+     * @brief Net a trade store file
+     *
+     * @throws std::runtime_error if the file cannot be read
+     */
+    std::vector<NetObligation> run(const std::string& path);
+
+    /**
+     * @brief Counters from the last run
+     */
+    const NettingStats& getStats() const { return stats_; }
+
+    std::size_t getNumThreads() const { return numThreads_; }
+
+private:
+    std::size_t numThreads_;
+    NettingStats stats_;
+};
+
+} // namespace engine
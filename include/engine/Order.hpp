@@ -1,10 +1,12 @@
 #pragma once
 
 #include <string>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <chrono>
 #include <random>
+#include <cmath>
 #include "engine/util/OrderIdGenerator.hpp"
 
 namespace engine {
@@ -47,6 +49,27 @@ public:
     using Price = double;
     using Quantity = std::uint64_t;
     using TimeStamp = std::chrono::time_point<std::chrono::system_clock>;
+    using InstrumentId = std::uint32_t;
+    using AccountId = std::uint32_t;
+    using PriceTicks = std::int32_t;
+    
+    // Integer prices carry 4 implied decimals, as in exchange feeds
+    static constexpr Price kTicksPerUnit = 10000.0;
+    static constexpr int kTickDecimals = 4;
+    
+    /**
+     * @brief Convert a price to integer ticks of 1/kTicksPerUnit
+     */
+    static PriceTicks toTicks(Price price) {
+        return static_cast<PriceTicks>(std::llround(price * kTicksPerUnit));
+    }
+    
+    /**
+     * @brief Convert integer ticks back to a price
+     */
+    static Price fromTicks(PriceTicks ticks) {
+        return ticks / kTicksPerUnit;
+    }
     
     /**
      * @brief Construct a new Order object
@@ -56,8 +79,11 @@ public:
      * @param type Order type (LIMIT or MARKET)
      * @param price Order price (not used for MARKET orders)
      * @param quantity Order quantity
+     * @param instrument Instrument (order book) the order is for
+     * @param account Trading account that owns the order
      */
-    Order(OrderId id, OrderSide side, OrderType type, Price price, Quantity quantity);
+    Order(OrderId id, OrderSide side, OrderType type, Price price, Quantity quantity,
+          InstrumentId instrument = 0, AccountId account = 0);
 
     /**
      * @brief Create a new order with an auto-generated ID
@@ -66,13 +92,16 @@ public:
      * @param type Order type (LIMIT or MARKET)
      * @param price Order price (ignored for MARKET orders)
      * @param quantity Order quantity
+     * @param instrument Instrument (order book) the order is for
+     * @param account Trading account that owns the order
      * @return std::shared_ptr<Order> A shared pointer to the new order
      */
     static std::shared_ptr<Order> createOrder(
-        OrderSide side, OrderType type, Price price, Quantity quantity) {
+        OrderSide side, OrderType type, Price price, Quantity quantity, InstrumentId instrument = 0,
+        AccountId account = 0) {
         
         OrderId id = util::OrderIdGenerator::getInstance().getNextId();
-        return std::make_shared<Order>(id, side, type, price, quantity);
+        return std::make_shared<Order>(id, side, type, price, quantity, instrument, account);
     }
     
     /**
@@ -80,11 +109,14 @@ public:
      * 
      * @param side BUY or SELL
      * @param quantity Order quantity
+     * @param instrument Instrument (order book) the order is for
+     * @param account Trading account that owns the order
      * @return std::shared_ptr<Order> A shared pointer to the new market order
      */
-    static std::shared_ptr<Order> createMarketOrder(OrderSide side, Quantity quantity) {
+    static std::shared_ptr<Order> createMarketOrder(OrderSide side, Quantity quantity, InstrumentId instrument = 0,
+                                                    AccountId account = 0) {
         OrderId id = util::OrderIdGenerator::getInstance().getNextId();
-        return std::make_shared<Order>(id, side, OrderType::MARKET, 0.0, quantity);
+        return std::make_shared<Order>(id, side, OrderType::MARKET, 0.0, quantity, instrument, account);
     }
     
     /**
@@ -95,12 +127,40 @@ public:
      * @param qtyMin Minimum quantity
      * @param qtyMax Maximum quantity
      * @param marketOrderProbability Probability of generating a market order (0.0 to 1.0)
+     * @param instrument Instrument (order book) the order is for
+     * @param account Trading account that owns the order
      * @return std::shared_ptr<Order> A shared pointer to the random order
      */
     static std::shared_ptr<Order> createRandomOrder(
         double priceMin = 90.0, double priceMax = 110.0,
         Quantity qtyMin = 1, Quantity qtyMax = 100,
-        double marketOrderProbability = 0.2) {
+        double marketOrderProbability = 0.2, InstrumentId instrument = 0, AccountId account = 0) {
+        
+        OrderId id = util::OrderIdGenerator::getInstance().getNextId();
+        return createRandomOrderWithId(id, priceMin, priceMax, qtyMin, qtyMax, marketOrderProbability,
+                                       instrument, account);
+    }
+    
+    /**
+     * @brief Create a random order with a given ID for testing purposes
+     * 
+     * Used by benchmarks that reserve a contiguous ID range and index per-order
+     * data by (id - first ID).
+     * 
+     * @param id Order ID to use
+     * @param priceMin Minimum price
+     * @param priceMax Maximum price
+     * @param qtyMin Minimum quantity
+     * @param qtyMax Maximum quantity
+     * @param marketOrderProbability Probability of generating a market order (0.0 to 1.0)
+     * @param instrument Instrument (order book) the order is for
+     * @param account Trading account that owns the order
+     * @return std::shared_ptr<Order> A shared pointer to the random order
+     */
+    static std::shared_ptr<Order> createRandomOrderWithId(
+        OrderId id, double priceMin = 90.0, double priceMax = 110.0,
+        Quantity qtyMin = 1, Quantity qtyMax = 100,
+        double marketOrderProbability = 0.2, InstrumentId instrument = 0, AccountId account = 0) {
         
         static thread_local std::mt19937 gen(std::random_device{}());
         std::uniform_real_distribution<> priceDist(priceMin, priceMax);
@@ -113,7 +173,7 @@ public:
         double price = std::round(priceDist(gen) * 100) / 100; // Round to 2 decimal places
         Quantity qty = qtyDist(gen);
         
-        return createOrder(side, type, price, qty);
+        return std::make_shared<Order>(id, side, type, price, qty, instrument, account);
     }
 
     // Getters
@@ -126,12 +186,15 @@ public:
     Quantity getRemainingQuantity() const { return quantity_ - filledQuantity_; }
     TimeStamp getTimestamp() const { return timestamp_; }
     OrderStatus getStatus() const { return status_; }
+    InstrumentId getInstrument() const { return instrument_; }
+    AccountId getAccount() const { return account_; }
     
     /**
      * @brief Record a fill against this order
      * 
      * @param fillQuantity Quantity that was filled
      * @return true if order is completely filled
+     * @throws std::invalid_argument if the quantity is zero or more than remains open
      */
     bool fill(Quantity fillQuantity);
     
@@ -140,10 +203,39 @@ public:
      */
     void cancel();
     
+    /**
+     * @brief Mark a new order as rejected before it reaches a book
+     */
+    void reject();
+    
+    /**
+     * @brief Reduce the open quantity of the order (partial cancel)
+     * 
+     * The order is canceled once nothing remains open.
+     * 
+     * @param reduceQuantity Quantity to take off the order
+     * @return true if the order was reduced
+     */
+    bool reduce(Quantity reduceQuantity);
+    
     /**
      * @brief String representation of the order
      */
     std::string toString() const;
+    
+    // Buffer size that always holds the output of formatTo
+    static constexpr std::size_t kMaxFormattedLength = 160;
+    
+    /**
+     * @brief Write the toString() text into a caller-provided buffer
+     * 
+     * Allocation-free and locale-independent. No terminating null is written.
+     * 
+     * @param buffer Destination
+     * @param size Capacity of the buffer
+     * @return std::size_t Characters written, or 0 if the buffer was too small
+     */
+    std::size_t formatTo(char* buffer, std::size_t size) const;
 
 private:
     OrderId id_;
@@ -154,6 +246,8 @@ private:
     Quantity filledQuantity_;
     TimeStamp timestamp_;
     OrderStatus status_;
+    InstrumentId instrument_;
+    AccountId account_;
 };
 
 } // namespace engine
@@ -2,11 +2,17 @@
 
 #include "Order.hpp"
 #include "Trade.hpp"
+#include "MemoryUsage.hpp"
+#include "CircuitBreaker.hpp"
+#include "TickTable.hpp"
+#include "engine/util/MemoryResources.hpp"
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <set>
 #include <memory>
+#include <memory_resource>
 #include <vector>
-#include <functional>
 #include <mutex>
 #include <shared_mutex>  // For readers-writer lock
 
@@ -45,26 +51,208 @@ struct SellOrderComparator {
  * 
  * Maintains separate books for buy and sell orders and implements matching logic.
  * Thread-safe implementation using readers-writer locks.
+ * 
+ * By default every container node of the book is allocated from an arena owned by
+ * the book, so a book's data stays together in memory, books do not contend on the
+ * global allocator, and destroying a book frees its memory in a few large chunks.
  */
 class OrderBook {
 public:
     using OrderPtr = std::shared_ptr<Order>;
-    using PriceLevel = std::multiset<OrderPtr, BuyOrderComparator>;
-    using OrderMap = std::map<Order::OrderId, OrderPtr>;
-    using TradeCallback = std::function<void(const Trade&)>;
+    using PriceLevel = std::pmr::multiset<OrderPtr, BuyOrderComparator>;
+    using OrderMap = std::pmr::map<Order::OrderId, OrderPtr>;
     
-    OrderBook();
+    /**
+     * @brief Construct a new Order Book
+     * 
+     * @param useArena Allocate the book's containers from a per-book arena (default: true);
+     *                 otherwise they use the global allocator
+     * @param upstream Resource the arena takes its chunks from
+     */
+    explicit OrderBook(bool useArena = true,
+                       std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
     
     /**
      * @brief Add an order to the book and perform matching
      * 
+     * Thread-safe implementation. The fill sink is a template parameter so the
+     * caller's handler is called directly and can be inlined; it runs under the
+     * book's lock, so a book's trades reach it in trade ID order.
+     * 
+     * @param order The order to add
+     * @param onFill Callable invoked with each trade generated by this order and
+     *               the accounts on both sides of it
+     * @return std::vector<Trade> Vector of trades generated from this order
+     */
+    template<typename FillSink>
+    std::vector<Trade> addOrder(OrderPtr order, FillSink&& onFill) {
+        return addOrder(std::move(order), [](const Order&) { return false; }, std::forward<FillSink>(onFill));
+    }
+    
+    /**
+     * @brief Add an order to the book and perform matching, unless a check under the book's lock turns it away
+     * 
+     * Thread-safe implementation. The check runs with the book's write lock
+     * held, so it is ordered against cancelAccountOrders() and every other
+     * change to the book: a flag set before a sweep of the book is seen by
+     * every order that enters the book after the sweep.
+     * 
+     * @param order The order to add
+     * @param blocked Predicate called as blocked(order) under the lock; true leaves the order REJECTED and out of the book
+     * @param onFill Callable invoked with each trade generated by this order and
+     *               the accounts on both sides of it
+     * @return std::vector<Trade> Vector of trades generated from this order; empty if it was blocked
+     */
+    template<typename Blocked, typename FillSink>
+    std::vector<Trade> addOrder(OrderPtr order, Blocked&& blocked, FillSink&& onFill) {
+        Order::AccountId account = order->getAccount();
+        Order::TimeStamp timestamp = order->getTimestamp();
+        bool buy = order->getSide() == OrderSide::BUY;
+        
+        // Lock exclusively as we're modifying the order book
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (blocked(*order)) {
+            order->reject();
+            return {};
+        }
+        std::vector<Trade> trades = matchOrder(std::move(order));
+        for (size_t i = 0; i < trades.size(); ++i) {
+            Order::AccountId resting = restingAccounts_[i];
+            onFill(Fill{trades[i], buy ? account : resting, buy ? resting : account, timestamp});
+        }
+        return trades;
+    }
+    
+    /**
+     * @brief Add an order to the book and perform matching, without trade notifications
+     * 
      * Thread-safe implementation.
      * 
      * @param order The order to add
-     * @param tradeCallback Callback for trade notifications
      * @return std::vector<Trade> Vector of trades generated from this order
      */
-    std::vector<Trade> addOrder(OrderPtr order, TradeCallback tradeCallback = nullptr);
+    std::vector<Trade> addOrder(OrderPtr order) {
+        return addOrder(std::move(order), [](const Fill&) {});
+    }
+    
+    /**
+     * @brief End a volatility interruption with a single-price auction
+     * 
+     * Thread-safe implementation. Crossing orders are executed at the price
+     * that maximizes the executed quantity (then minimizes the imbalance, then
+     * is closest to the reference price), in price-time priority. The auction
+     * price becomes the new static and dynamic reference, and the book returns
+     * to continuous trading. The sink runs under the book's lock.
+     * 
+     * @param onFill Callable invoked as onFill(fill, buyOrder, sellOrder) for each auction trade
+     * @return std::vector<Trade> The auction trades
+     */
+    template<typename AuctionSink>
+    std::vector<Trade> uncross(AuctionSink&& onFill) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        std::vector<Trade> trades = runAuction();
+        Order::TimeStamp timestamp = std::chrono::system_clock::now();
+        for (size_t i = 0; i < trades.size(); ++i) {
+            const Order& buy = *auctionMatches_[i].first;
+            const Order& sell = *auctionMatches_[i].second;
+            onFill(Fill{trades[i], buy.getAccount(), sell.getAccount(), timestamp}, buy, sell);
+        }
+        auctionMatches_.clear();
+        return trades;
+    }
+    
+    /**
+     * @brief Set the price bands that interrupt continuous trading
+     * 
+     * Thread-safe implementation.
+     */
+    void setCircuitBreaker(const CircuitBreakerConfig& config);
+    
+    /**
+     * @brief Set the static and dynamic reference price, e.g. to the previous close
+     * 
+     * Thread-safe implementation.
+     */
+    void setReferencePrice(Order::Price price);
+    
+    /**
+     * @brief Get the trading phase; lock-free
+     */
+    TradingState getTradingState() const { return state_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Check whether an interruption has lasted its configured time; lock-free
+     * 
+     * Reads the clock only while the book is in an auction.
+     */
+    bool isAuctionDue() const {
+        if (state_.load(std::memory_order_relaxed) != TradingState::AUCTION) {
+            return false;
+        }
+        std::int64_t length = interruptionNanoseconds_.load(std::memory_order_relaxed);
+        return length > 0 && steadyNanoseconds() - auctionStartNanoseconds_.load(std::memory_order_relaxed) >= length;
+    }
+    
+    /**
+     * @brief Number of volatility interruptions so far
+     */
+    std::uint64_t getInterruptionCount() const { return interruptions_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Get the price band trades must currently print in
+     * 
+     * Thread-safe implementation.
+     * 
+     * @return Lowest and highest allowed price; unbounded sides are the limits of the tick range
+     */
+    std::pair<Order::Price, Order::Price> getPriceBand() const;
+    
+    /**
+     * @brief Cancel a resting order
+     * 
+     * Thread-safe implementation.
+     * 
+     * @param orderId ID of the order to cancel
+     * @param canceledQuantity If given, set to the open quantity taken off the book
+     * @return true if the order was resting in the book and has been removed
+     */
+    bool cancelOrder(Order::OrderId orderId, Order::Quantity* canceledQuantity = nullptr);
+    
+    /**
+     * @brief Reduce the open quantity of a resting order
+     * 
+     * The order keeps its time priority. It is removed from the book once
+     * nothing remains open.
+     * 
+     * Thread-safe implementation.
+     * 
+     * @param orderId ID of the order to reduce
+     * @param quantity Quantity to take off the order
+     * @param reducedQuantity If given, set to the open quantity actually taken off
+     * @return true if the order was resting in the book and has been reduced
+     */
+    bool reduceOrder(Order::OrderId orderId, Order::Quantity quantity, Order::Quantity* reducedQuantity = nullptr);
+    
+    /**
+     * @brief Cancel every resting order of an account
+     * 
+     * Thread-safe implementation. Walks the ID map under the write lock, so it
+     * is O(n) in resting orders and meant for a kill switch, not the hot path.
+     * 
+     * @param account Account whose orders to cancel
+     * @return std::vector<OrderPtr> The canceled orders; each one's remaining quantity is what left the book
+     */
+    std::vector<OrderPtr> cancelAccountOrders(Order::AccountId account);
+    
+    /**
+     * @brief Look up a resting order by ID
+     * 
+     * Thread-safe implementation.
+     * 
+     * @param orderId ID of the order to find
+     * @return OrderPtr The resting order, or nullptr if it is not in the book
+     */
+    OrderPtr findOrder(Order::OrderId orderId) const;
     
     /**
      * @brief Get best bid price (highest buy price)
@@ -84,6 +272,31 @@ public:
      */
     Order::Price getBestAskPrice() const;
     
+    /**
+     * @brief Set the tick regime of the book's instrument
+     * 
+     * Thread-safe implementation. The engine sets it from the instrument's
+     * reference data; prices of resting orders are expected to be on its grid.
+     */
+    void setTickTable(const TickTable& table);
+    
+    /**
+     * @brief Get the tick regime of the book's instrument
+     * 
+     * Thread-safe implementation.
+     */
+    TickTable getTickTable() const;
+    
+    /**
+     * @brief Get the spread as a number of price levels on the tick grid
+     * 
+     * Thread-safe implementation. Counts levels across tick band boundaries,
+     * so a spread straddling two bands is measured in the ticks of both.
+     * 
+     * @return Levels from the best bid up to the best ask; 0 if a side is empty or the book is crossed
+     */
+    TickTable::Level getSpreadLevels() const;
+    
     /**
      * @brief Print the current state of the order book
      * 
@@ -101,17 +314,63 @@ public:
      */
     size_t getSellOrderCount() const;
     
+    /**
+     * @brief Remove every resting order without generating trades or notifications
+     * 
+     * The trade sequence restarts at 1.
+     * 
+     * Thread-safe implementation. The freed container nodes stay in the book's
+     * arena, so memory touched before a reset is already faulted in afterwards.
+     */
+    void reset();
+    
+    /**
+     * @brief Get the memory held by the book
+     * 
+     * Thread-safe implementation. Walks both sides to count price levels, so it
+     * is O(n) in resting orders and meant for monitoring, not the hot path.
+     * 
+     * @return MemoryUsage Memory by category (queue fields are zero)
+     */
+    MemoryUsage getMemoryUsage() const;
+    
 private:
-    using BuyOrderBook = std::multiset<OrderPtr, BuyOrderComparator>;
-    using SellOrderBook = std::multiset<OrderPtr, SellOrderComparator>;
+    using BuyOrderBook = std::pmr::multiset<OrderPtr, BuyOrderComparator>;
+    using SellOrderBook = std::pmr::multiset<OrderPtr, SellOrderComparator>;
+    
+    // Declared before the containers so it outlives them
+    std::unique_ptr<util::Arena> arena_;
     
     BuyOrderBook buyOrders_;
     SellOrderBook sellOrders_;
     OrderMap orderMap_;  // For fast lookups by ID
+    Trade::TradeId nextTradeId_ = 1;  // Per-book trade sequence
+    std::vector<Order::AccountId> restingAccounts_;  // Resting side's account per trade of the last match
+    std::vector<std::pair<OrderPtr, OrderPtr>> auctionMatches_;  // Buy and sell order per trade of the last auction
+    
+    TickTable tickTable_;
+    
+    // Circuit breaker; the state is written under the lock and read lock-free
+    CircuitBreaker breaker_;
+    std::atomic<TradingState> state_{TradingState::CONTINUOUS};
+    std::atomic<std::int64_t> auctionStartNanoseconds_{0};
+    std::atomic<std::int64_t> interruptionNanoseconds_{0};
+    std::atomic<std::uint64_t> interruptions_{0};
     
     // Reader-writer lock for concurrent access
     mutable std::shared_mutex mutex_;
     
+    /**
+     * @brief Match a new order and rest whatever a limit order has left
+     * 
+     * Note: This method is NOT thread-safe on its own and should be called
+     * with appropriate locking in place.
+     * 
+     * @param order The order to add
+     * @return std::vector<Trade> Resulting trades
+     */
+    std::vector<Trade> matchOrder(OrderPtr order);
+    
     /**
      * @brief Match a new buy order against the sell book
      * 
@@ -119,10 +378,9 @@ private:
      * with appropriate locking in place.
      * 
      * @param buyOrder Buy order to match
-     * @param tradeCallback Callback for trade notifications
      * @return std::vector<Trade> Resulting trades
      */
-    std::vector<Trade> matchBuyOrder(OrderPtr buyOrder, TradeCallback tradeCallback);
+    std::vector<Trade> matchBuyOrder(OrderPtr buyOrder);
     
     /**
      * @brief Match a new sell order against the buy book
@@ -131,10 +389,48 @@ private:
      * with appropriate locking in place.
      * 
      * @param sellOrder Sell order to match
-     * @param tradeCallback Callback for trade notifications
      * @return std::vector<Trade> Resulting trades
      */
-    std::vector<Trade> matchSellOrder(OrderPtr sellOrder, TradeCallback tradeCallback);
+    std::vector<Trade> matchSellOrder(OrderPtr sellOrder);
+    
+    /**
+     * @brief Stop continuous trading after a trade price fell outside the bands
+     * 
+     * Note: This method is NOT thread-safe on its own and should be called
+     * with appropriate locking in place.
+     */
+    void startAuction(Order::InstrumentId instrument, Order::PriceTicks price);
+    
+    /**
+     * @brief Find the uncrossing price of a crossed book
+     * 
+     * Note: This method is NOT thread-safe on its own and should be called
+     * with appropriate locking in place.
+     */
+    Order::PriceTicks auctionPrice() const;
+    
+    /**
+     * @brief Execute the crossing orders at the auction price and resume continuous trading
+     * 
+     * Note: This method is NOT thread-safe on its own and should be called
+     * with appropriate locking in place.
+     */
+    std::vector<Trade> runAuction();
+    
+    static std::int64_t steadyNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    /**
+     * @brief Remove a resting order from its side of the book and from the ID map
+     * 
+     * Note: This method is NOT thread-safe on its own and should be called
+     * with appropriate locking in place.
+     * 
+     * @param order The resting order to remove
+     */
+    void removeRestingOrder(const OrderPtr& order);
 };
 
 } // namespace engine
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Order.hpp"
+#include "OrderRequest.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace engine {
+
+/**
+ * @brief Fixed-size binary journal record of an inbound request
+ */
+struct JournalRecord {
+    Order::OrderId orderId;
+    Order::Quantity quantity;           // NEW: order quantity; REDUCE: quantity to take off
+    std::int64_t timestampNanoseconds;  // NEW: order timestamp; CANCEL and REDUCE: time journaled; since the epoch
+    Order::PriceTicks price;            // NEW only
+    Order::InstrumentId instrument;
+    std::uint8_t side;                  // NEW only
+    std::uint8_t type;                  // NEW only
+    std::uint8_t request;               // OrderRequestType; NEW is 0
+    std::uint8_t reserved;
+    Order::AccountId account;  // NEW only; risk, halts and positions are kept per account
+};
+
+static_assert(sizeof(JournalRecord) == 40, "Journal records must stay at 40 bytes");
+
+/**
+ * @brief Append-only binary journal of inbound orders, cancels and reductions
+ * 
+ * Records are appended to a large stdio buffer and handed to the kernel once
+ * per batch with flush(), so journaling costs a copy per order and a write
+ * call per batch. Durability against power loss (fsync) is left to the caller.
+ * 
+ * Neither append() nor flush() throws, since they run on a pipeline stage
+ * thread. After the first write error the journal stops: the error is logged
+ * once, and the records buffered since the last successful flush and every
+ * record appended afterwards are counted as lost instead of written.
+ */
+class OrderJournal {
+public:
+    /**
+     * @brief Open a journal file, truncating it
+     * 
+     * @param path File to write
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    explicit OrderJournal(const std::string& path);
+    
+    /**
+     * @brief Flushes and closes the file
+     */
+    ~OrderJournal();
+    
+    /**
+     * @brief Append a new order to the journal
+     * 
+     * @return false if the record was lost
+     */
+    bool append(const Order& order);
+    
+    /**
+     * @brief Append a request to the journal; a NEW request is journaled as its order
+     * 
+     * @return false if the record was lost
+     */
+    bool append(const OrderRequest& request);
+    
+    /**
+     * @brief Hand buffered records to the kernel
+     * 
+     * @return false if the journal has stopped
+     */
+    bool flush();
+    
+    /**
+     * @brief Number of records appended and not lost so far
+     */
+    std::uint64_t recordsWritten() const { return recordsWritten_; }
+    
+    /**
+     * @brief Number of records lost to a write error
+     */
+    std::uint64_t recordsLost() const { return recordsLost_; }
+    
+    /**
+     * @brief Check whether a write error has stopped the journal
+     */
+    bool failed() const { return failed_; }
+    
+    /**
+     * @brief Bytes held by the stdio buffer
+     */
+    std::size_t memoryBytes() const { return kBufferBytes; }
+    
+    // Delete copy constructor/assignment
+    OrderJournal(const OrderJournal&) = delete;
+    OrderJournal& operator=(const OrderJournal&) = delete;
+
+private:
+    static constexpr std::size_t kBufferBytes = 1 << 20;
+    
+    bool write(const JournalRecord& record);
+    
+    /**
+     * @brief Stop journaling and count the records that never reached the kernel
+     */
+    void fail();
+    
+    std::FILE* file_;
+    std::uint64_t recordsWritten_ = 0;
+    std::uint64_t recordsLost_ = 0;
+    std::uint64_t recordsBuffered_ = 0;  // Appended since the last successful flush
+    bool failed_ = false;
+};
+
+} // namespace engine
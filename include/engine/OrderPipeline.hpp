@@ -0,0 +1,373 @@
+#pragma once
+
+#include "Order.hpp"
+#include "OrderRequest.hpp"
+#include "Trade.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace engine {
+
+/**
+ * @brief Throughput of one pipeline stage
+ */
+struct PipelineStageStats {
+    std::string name;
+    std::uint64_t processed;  // Requests handled by the stage, new orders and cancels
+    std::uint64_t batches;    // Times the stage woke up and found work
+};
+
+/**
+ * @brief Ring-based order pipeline with dependency barriers between stages
+ *
+ * Every request moves through one preallocated ring slot:
+ *
+ *     ingress --+--> risk ----+--> match --> publish
+ *               +--> journal -+
+ *
+ * Ingress is the submitting threads, which claim a slot with one atomic add.
+ * Cancels and reductions take slots like new orders, so every request reaches
+ * the match stage in the order it was claimed and a cancel can never overtake
+ * the order it names.
+ * Risk and journal run in parallel behind ingress, match waits for both, and
+ * publish waits for match. Every other stage runs on its own thread and only
+ * touches the slots and cursors of its own barrier. Each stage processes
+ * everything that is available in one batch and then advances its cursor
+ * once, so throughput is bounded by the slowest stage, not by their sum.
+ *
+ * The stage work is supplied by a Stages type with these members, called on
+ * the stage threads:
+ *
+ *     bool checkRisk(Order& order);                  // false rejects the order
+ *     void journal(const OrderRequest& request);
+ *     void endJournalBatch();
+ *     void match(const std::shared_ptr<Order>& order, std::vector<Fill>& fills);
+ *     std::shared_ptr<Order> cancel(const OrderRequest& request);  // the order it applied to, or null
+ *     void publish(const Order& order, const std::vector<Fill>& fills, bool rejected);
+ *     void publishCancel(const Order* order);        // null if the cancel missed
+ *
+ * checkRisk sees new orders only; cancel runs on the match stage. None of
+ * them may throw, since nothing on a stage thread would catch it.
+ *
+ * @tparam Stages Stage implementation, called directly so it can be inlined
+ */
+template<typename Stages>
+class OrderPipeline {
+public:
+    static constexpr std::size_t kDefaultCapacity = 1 << 16;
+
+    /**
+     * @brief Create a pipeline
+     *
+     * @param stages Stage implementation
+     * @param capacity Number of slots (rounded up to a power of two)
+     * @param pinStages Pin each stage thread to its own CPU, where supported
+     */
+    OrderPipeline(Stages stages, std::size_t capacity = kDefaultCapacity, bool pinStages = false)
+        : stages_(std::move(stages)),
+          slots_(roundUpToPowerOfTwo(std::max<std::size_t>(capacity, 2))),
+          mask_(slots_.size() - 1),
+          pinStages_(pinStages) {
+        gatingLimit_.store(slots_.size());
+    }
+
+    /**
+     * @brief Stops the stage threads
+     */
+    ~OrderPipeline() {
+        stop();
+    }
+
+    /**
+     * @brief Start the stage threads
+     */
+    void start() {
+        if (!threads_.empty()) return;
+        stopping_ = false;
+        threads_.emplace_back([this] { runRisk(); });
+        threads_.emplace_back([this] { runJournal(); });
+        threads_.emplace_back([this] { runMatch(); });
+        threads_.emplace_back([this] { runPublish(); });
+        if (pinStages_) {
+            pinThreads();
+        }
+    }
+
+    /**
+     * @brief Finish every request already submitted, then stop the stage threads
+     *
+     * Submission must have stopped before this is called.
+     */
+    void stop() {
+        stopping_ = true;
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        threads_.clear();
+    }
+
+    /**
+     * @brief Put an order into the pipeline (the ingress stage)
+     *
+     * Thread-safe; waits only if the pipeline is a full ring behind.
+     *
+     * @param order The order to process
+     */
+    void submit(std::shared_ptr<Order> order) {
+        submit(OrderRequest::newOrder(std::move(order)));
+    }
+
+    /**
+     * @brief Put a request into the pipeline; a cancel or reduction is applied by the match stage
+     *
+     * Thread-safe; waits only if the pipeline is a full ring behind.
+     *
+     * @param request The request to process
+     */
+    void submit(OrderRequest request) {
+        fillSlot(claimed_.fetch_add(1, std::memory_order_relaxed), std::move(request));
+    }
+
+    /**
+     * @brief Put a batch of orders into the pipeline, claiming their slots with one atomic add
+     *
+     * The batch occupies consecutive sequences, so orders from other
+     * submitting threads never interleave with it. Thread-safe; waits only
+     * if the pipeline is a full ring behind.
+     *
+     * @param orders The orders to process; they are moved from
+     * @param count Number of orders
+     */
+    void submit(std::shared_ptr<Order>* orders, std::size_t count) {
+        if (count == 0) return;
+        std::uint64_t first = claimed_.fetch_add(count, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < count; ++i) {
+            fillSlot(first + i, OrderRequest::newOrder(std::move(orders[i])));
+        }
+    }
+
+    /**
+     * @brief Get processed-order and batch counts for every stage
+     */
+    std::vector<PipelineStageStats> getStageStats() const {
+        return {
+            {"risk", riskCursor_.value.load(), riskCursor_.batches.load()},
+            {"journal", journalCursor_.value.load(), journalCursor_.batches.load()},
+            {"match", matchCursor_.value.load(), matchCursor_.batches.load()},
+            {"publish", publishCursor_.value.load(), publishCursor_.batches.load()}
+        };
+    }
+
+    /**
+     * @brief Bytes held by the preallocated slots and the fill buffers they have grown
+     *
+     * Thread-safe; the fill buffers are tracked by the match stage as they grow.
+     */
+    std::size_t memoryBytes() const {
+        return slots_.size() * sizeof(Slot) + fillBytes_.load(std::memory_order_relaxed);
+    }
+
+    // Delete copy constructor/assignment
+    OrderPipeline(const OrderPipeline&) = delete;
+    OrderPipeline& operator=(const OrderPipeline&) = delete;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> published{0};  // Sequence + 1 once ingress has written the slot
+        OrderRequest request;
+        std::shared_ptr<Order> target;  // CANCEL and REDUCE: the order the match stage applied it to
+        std::vector<Fill> fills;  // Keeps its capacity across laps
+        bool rejected = false;
+    };
+
+    /**
+     * @brief Cursor of a stage: every sequence below value has been processed
+     */
+    struct alignas(64) Cursor {
+        std::atomic<std::uint64_t> value{0};
+        std::atomic<std::uint64_t> batches{0};
+
+        void advance(std::uint64_t to) {
+            batches.store(batches.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            value.store(to, std::memory_order_release);
+        }
+    };
+
+    /**
+     * @brief Write a request into the slot of a claimed sequence and hand it to the stages
+     */
+    void fillSlot(std::uint64_t sequence, OrderRequest request) {
+        // Do not overwrite a slot the publish stage has not finished with
+        if (sequence >= gatingLimit_.load(std::memory_order_acquire)) {
+            std::uint64_t limit;
+            while (sequence >= (limit = publishCursor_.value.load(std::memory_order_acquire) + slots_.size())) {
+                std::this_thread::yield();
+            }
+            gatingLimit_.store(limit, std::memory_order_release);
+        }
+
+        Slot& slot = slots_[sequence & mask_];
+        slot.request = std::move(request);
+        slot.rejected = false;
+        slot.published.store(sequence + 1, std::memory_order_release);
+    }
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t value) {
+        std::size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Highest contiguous sequence ingress has published, starting at from
+     */
+    std::uint64_t ingressAvailable(std::uint64_t from) const {
+        while (slots_[from & mask_].published.load(std::memory_order_acquire) == from + 1) {
+            ++from;
+        }
+        return from;
+    }
+
+    /**
+     * @brief Run a stage until stop() is called and all submitted requests passed it
+     *
+     * @param cursor The stage's own cursor
+     * @param available Returns the end of the sequence range the stage may process
+     * @param process Handles one sequence
+     * @param endBatch Called after each batch
+     */
+    template<typename Available, typename Process, typename EndBatch>
+    void runStage(Cursor& cursor, Available available, Process process, EndBatch endBatch) {
+        std::uint64_t next = cursor.value.load(std::memory_order_relaxed);
+        int idle = 0;
+
+        while (true) {
+            std::uint64_t end = available(next);
+            if (end > next) {
+                for (std::uint64_t sequence = next; sequence < end; ++sequence) {
+                    process(slots_[sequence & mask_]);
+                }
+                endBatch();
+                next = end;
+                cursor.advance(next);
+                idle = 0;
+                continue;
+            }
+
+            if (stopping_.load(std::memory_order_acquire) && next >= claimed_.load(std::memory_order_acquire)) {
+                return;
+            }
+            if (++idle < kIdleSpins) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+
+    void runRisk() {
+        runStage(riskCursor_,
+                 [this](std::uint64_t next) { return ingressAvailable(next); },
+                 [this](Slot& slot) {
+                     if (slot.request.type == OrderRequestType::NEW) {
+                         slot.rejected = !stages_.checkRisk(*slot.request.order);
+                     }
+                 },
+                 [] {});
+    }
+
+    void runJournal() {
+        runStage(journalCursor_,
+                 [this](std::uint64_t next) { return ingressAvailable(next); },
+                 [this](Slot& slot) { stages_.journal(slot.request); },
+                 [this] { stages_.endJournalBatch(); });
+    }
+
+    void runMatch() {
+        runStage(matchCursor_,
+                 [this](std::uint64_t) {
+                     return std::min(riskCursor_.value.load(std::memory_order_acquire),
+                                     journalCursor_.value.load(std::memory_order_acquire));
+                 },
+                 [this](Slot& slot) {
+                     slot.fills.clear();
+                     if (slot.request.type != OrderRequestType::NEW) {
+                         slot.target = stages_.cancel(slot.request);
+                     } else if (!slot.rejected) {
+                         std::size_t capacity = slot.fills.capacity();
+                         stages_.match(slot.request.order, slot.fills);
+                         if (slot.fills.capacity() != capacity) {
+                             fillBytes_.fetch_add((slot.fills.capacity() - capacity) * sizeof(Fill),
+                                                  std::memory_order_relaxed);
+                         }
+                     }
+                 },
+                 [] {});
+    }
+
+    void runPublish() {
+        runStage(publishCursor_,
+                 [this](std::uint64_t) { return matchCursor_.value.load(std::memory_order_acquire); },
+                 [this](Slot& slot) {
+                     if (slot.request.type != OrderRequestType::NEW) {
+                         stages_.publishCancel(slot.target.get());
+                         slot.target.reset();
+                     } else {
+                         stages_.publish(*slot.request.order, slot.fills, slot.rejected);
+                         slot.request.order.reset();
+                     }
+                 },
+                 [] {});
+    }
+
+    void pinThreads() {
+#if defined(__linux__)
+        unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t i = 0; i < threads_.size(); ++i) {
+            // Leave CPU 0 to the submitting threads when there are enough CPUs
+            unsigned cpu = static_cast<unsigned>((i + 1) % cpus);
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(threads_[i].native_handle(), sizeof(set), &set);
+        }
+#endif
+    }
+
+    // Empty polls a stage spins through before it starts sleeping
+    static constexpr int kIdleSpins = 64;
+
+    Stages stages_;
+    std::vector<Slot> slots_;
+    const std::uint64_t mask_;
+    const bool pinStages_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::size_t> fillBytes_{0};  // Capacity of the slots' fill buffers, in bytes
+
+    alignas(64) std::atomic<std::uint64_t> claimed_{0};
+    // Sequences below this limit cannot overwrite an unpublished slot; refreshed when reached
+    alignas(64) std::atomic<std::uint64_t> gatingLimit_{0};
+    Cursor riskCursor_;
+    Cursor journalCursor_;
+    Cursor matchCursor_;
+    Cursor publishCursor_;
+};
+
+} // namespace engine
@@ -1,7 +1,13 @@
 #pragma once
 
 #include "Order.hpp"
-#include <queue>
+#include "OrderRequest.hpp"
+#include "MemoryUsage.hpp"
+#include "LaneSequencer.hpp"
+#include "engine/util/MemoryResources.hpp"
+#include "engine/util/FlatPointerMap.hpp"
+#include <cstdint>
+#include <memory_resource>
 #include <mutex>
 #include <condition_variable>
 #include <memory>
@@ -10,13 +16,54 @@
 namespace engine {
 
 /**
- * @brief Thread-safe queue for orders
+ * @brief What the queue did with a request
+ */
+enum class EnqueueAction : std::uint8_t {
+    QUEUED,    // Added to the queue
+    MERGED,    // Folded into a cancel or reduction already queued for the same order
+    AMENDED,   // Reduced the order while it waits in the queue; it still goes to its book
+    ANNULLED   // Canceled the order while it waits in the queue; it never reaches its book
+};
+
+/**
+ * @brief Outcome of OrderQueue::enqueue
+ */
+struct EnqueueResult {
+    EnqueueAction action = EnqueueAction::QUEUED;
+    std::shared_ptr<Order> order;          // AMENDED and ANNULLED: the queued order
+    Order::Quantity removedQuantity = 0;   // AMENDED and ANNULLED: open quantity taken off it
+};
+
+/**
+ * @brief Thread-safe queue for order requests
+ * 
+ * Implements a producer-consumer pattern for order processing. Cancels and
+ * reductions can be given a lane of their own, so that in a burst they are
+ * taken ahead of new orders that are still waiting (see LaneSequencer).
  * 
- * Implements a producer-consumer pattern for order processing
+ * Requests still waiting are indexed by order ID, so a cancel or reduction
+ * for an order that has not been dequeued yet is applied to it in the queue:
+ * a cancel annuls it, and a reduction shrinks it before it reaches the book.
+ * A cancel or reduction for an order that already left the queue is folded
+ * into one that is still waiting for the same order, so a burst of amends
+ * reaches the book as a single request.
  */
 class OrderQueue {
 public:
-    OrderQueue() = default;
+    /**
+     * @brief Construct a new Order Queue
+     * 
+     * @param useArena Allocate queue slots from an arena owned by the queue (default: true)
+     * @param upstream Resource the arena takes its chunks from
+     * @param maxCancelRun Cancels and reductions that may overtake a waiting new order in a row; 0 keeps arrival order
+     */
+    explicit OrderQueue(bool useArena = true,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource(),
+                        std::size_t maxCancelRun = 0)
+        : arena_(useArena ? std::make_unique<util::Arena>(upstream) : nullptr),
+          queue_(maxCancelRun, arena_ ? arena_->resource() : std::pmr::get_default_resource()),
+          waitingOrders_(1024, arena_ ? arena_->resource() : std::pmr::get_default_resource()),
+          waitingCancels_(1024, arena_ ? arena_->resource() : std::pmr::get_default_resource()) {}
     
     /**
      * @brief Add an order to the queue
@@ -24,45 +71,86 @@ public:
      * @param order The order to enqueue
      */
     void enqueue(std::shared_ptr<Order> order) {
+        enqueue(OrderRequest::newOrder(std::move(order)));
+    }
+    
+    /**
+     * @brief Add a batch of orders to the queue under one lock acquisition
+     * 
+     * The batch is queued contiguously and the consumers are notified once,
+     * so the cost of the lock and the wakeup is paid per batch, not per order.
+     * Waking every idle worker rather than one lets the batch be worked off
+     * in parallel.
+     * 
+     * @param orders The orders to enqueue; they are moved from
+     * @param count Number of orders
+     */
+    void enqueue(std::shared_ptr<Order>* orders, std::size_t count) {
+        if (count == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (std::size_t i = 0; i < count; ++i) {
+                push(OrderRequest::newOrder(std::move(orders[i])));
+            }
+        }
+        if (count == 1) {
+            cv_.notify_one();
+        } else {
+            cv_.notify_all();
+        }
+    }
+    
+    /**
+     * @brief Add a request to the back of its lane, or coalesce it with a waiting one
+     * 
+     * Only a request that was QUEUED will be dequeued; the others are done
+     * when this returns.
+     * 
+     * @param request The request to enqueue
+     * @return EnqueueResult What was done with the request
+     */
+    EnqueueResult enqueue(OrderRequest request) {
+        EnqueueResult result;
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            queue_.push(order);
+            result = coalesce(request);
+            if (result.action != EnqueueAction::QUEUED) {
+                return result;
+            }
+            push(std::move(request));
         }
         cv_.notify_one();
+        return result;
     }
     
     /**
-     * @brief Try to get an order from the queue without blocking
+     * @brief Try to get a request from the queue without blocking
      * 
-     * @return std::optional<std::shared_ptr<Order>> The order or empty if queue is empty
+     * @return std::optional<OrderRequest> The request or empty if queue is empty
      */
-    std::optional<std::shared_ptr<Order>> tryDequeue() {
+    std::optional<OrderRequest> tryDequeue() {
         std::lock_guard<std::mutex> lock(mutex_);
-        if (queue_.empty()) {
+        if (live_ == 0) {
             return std::nullopt;
         }
-        
-        auto order = queue_.front();
-        queue_.pop();
-        return order;
+        return pop();
     }
     
     /**
-     * @brief Get an order from the queue, blocking if empty
+     * @brief Get a request from the queue, blocking if empty
      * 
-     * @return std::shared_ptr<Order> The next order in the queue
+     * @return std::optional<OrderRequest> The next request, or empty once the queue is shut down and drained
      */
-    std::shared_ptr<Order> dequeue() {
+    std::optional<OrderRequest> dequeue() {
         std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [this] { return !queue_.empty() || shutdown_; });
+        cv_.wait(lock, [this] { return live_ > 0 || shutdown_; });
         
-        if (shutdown_ && queue_.empty()) {
-            return nullptr;  // Return nullptr when shutting down
+        if (shutdown_ && live_ == 0) {
+            return std::nullopt;
         }
-        
-        auto order = queue_.front();
-        queue_.pop();
-        return order;
+        return pop();
     }
     
     /**
@@ -72,7 +160,7 @@ public:
      */
     bool empty() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.empty();
+        return live_ == 0;
     }
     
     /**
@@ -82,7 +170,43 @@ public:
      */
     std::size_t size() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.size();
+        return live_;
+    }
+    
+    /**
+     * @brief Get the memory held by queued requests
+     * 
+     * @return MemoryUsage Queue slots and the queued orders themselves
+     */
+    MemoryUsage getMemoryUsage() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        MemoryUsage usage;
+        usage.queuedOrders = newOrders_;
+        usage.queueBytes = queue_.size() * sizeof(OrderRequest) + newOrders_ * memory::kSharedOrderBytes +
+                           waitingOrders_.memoryBytes() + waitingCancels_.memoryBytes();
+        usage.arenaBytes = arena_ ? arena_->reservedBytes() : 0;
+        return usage;
+    }
+    
+    /**
+     * @brief Grow the queue to the given number of slots and drain it again
+     * 
+     * Faults in the queue's arena ahead of time; the released buffers stay in the arena.
+     * Does nothing if orders are already queued.
+     * 
+     * @param slots Number of slots to touch
+     */
+    void prefault(std::size_t slots) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!queue_.empty()) {
+            return;
+        }
+        for (std::size_t i = 0; i < slots; ++i) {
+            queue_.push(OrderRequest{}, false);
+        }
+        while (!queue_.empty()) {
+            queue_.pop();
+        }
     }
     
     /**
@@ -95,7 +219,98 @@ public:
     }
     
 private:
-    std::queue<std::shared_ptr<Order>> queue_;
+    // Waiting requests by order ID; the pointers stay valid until the request is popped
+    using RequestIndex = util::FlatPointerMap<OrderRequest>;
+    
+    /**
+     * @brief Apply a cancel or reduction to a waiting order or request for the same order
+     * 
+     * Must be called with the mutex held.
+     * 
+     * @return EnqueueResult QUEUED if there was nothing to coalesce with
+     */
+    EnqueueResult coalesce(const OrderRequest& request) {
+        EnqueueResult result;
+        if (request.type == OrderRequestType::NEW) {
+            return result;
+        }
+        
+        OrderRequest* queued = waitingOrders_.find(request.orderId);
+        if (queued && queued->instrument == request.instrument) {
+            OrderRequest& waiting = *queued;
+            Order& order = *waiting.order;
+            Order::Quantity open = order.getRemainingQuantity();
+            if (request.type == OrderRequestType::CANCEL) {
+                order.cancel();
+            } else {
+                order.reduce(request.quantity);
+            }
+            result.order = waiting.order;
+            
+            // A reduction to nothing also leaves the order CANCELED; either way it must not reach the book
+            if (order.getStatus() == OrderStatus::CANCELED) {
+                result.action = EnqueueAction::ANNULLED;
+                result.removedQuantity = open;
+                waiting.order.reset();
+                waitingOrders_.erase(request.orderId, queued);
+                live_--;
+                newOrders_--;
+            } else {
+                result.action = EnqueueAction::AMENDED;
+                result.removedQuantity = open - order.getRemainingQuantity();
+            }
+            return result;
+        }
+        
+        OrderRequest* pending = waitingCancels_.find(request.orderId);
+        if (pending && pending->instrument == request.instrument) {
+            OrderRequest& waiting = *pending;
+            if (request.type == OrderRequestType::CANCEL) {
+                waiting.type = OrderRequestType::CANCEL;
+            } else if (waiting.type == OrderRequestType::REDUCE) {
+                waiting.quantity += request.quantity;
+            }
+            result.action = EnqueueAction::MERGED;
+        }
+        return result;
+    }
+    
+    void push(OrderRequest request) {
+        bool isNew = request.type == OrderRequestType::NEW;
+        Order::OrderId orderId = request.orderId;
+        
+        // A cancel never overtakes its own order; coalesce() absorbs it unless the order names another book
+        bool priority = !isNew && !waitingOrders_.find(orderId);
+        OrderRequest& queued = queue_.push(std::move(request), priority);
+        (isNew ? waitingOrders_ : waitingCancels_).insert(orderId, &queued);
+        newOrders_ += isNew;
+        live_++;
+    }
+    
+    // Skips orders annulled while they waited; there is at least one live request
+    OrderRequest pop() {
+        while (true) {
+            OrderRequest& next = queue_.next();
+            RequestIndex& index = next.type == OrderRequestType::NEW ? waitingOrders_ : waitingCancels_;
+            index.erase(next.orderId, &next);
+            
+            OrderRequest request = queue_.pop();
+            if (request.type == OrderRequestType::NEW && !request.order) {
+                continue;
+            }
+            newOrders_ -= request.type == OrderRequestType::NEW;
+            live_--;
+            return request;
+        }
+    }
+    
+    // Declared before the queue so it outlives it
+    std::unique_ptr<util::Arena> arena_;
+    LaneSequencer<OrderRequest> queue_;
+    RequestIndex waitingOrders_;   // NEW requests
+    RequestIndex waitingCancels_;  // CANCEL and REDUCE requests
+    std::size_t live_ = 0;         // Waiting requests that will be dequeued
+    std::size_t newOrders_ = 0;    // Of those, new orders
     mutable std::mutex mutex_;
     std::condition_variable cv_;
     bool shutdown_ = false;
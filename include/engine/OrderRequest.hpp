@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Order.hpp"
+#include <cstdint>
+#include <memory>
+
+namespace engine {
+
+/**
+ * @brief Kind of request carried by the ingress queue and the pipeline ring
+ */
+enum class OrderRequestType : std::uint8_t {
+    NEW,     // A new order to match
+    CANCEL,  // Cancel a resting order
+    REDUCE   // Take quantity off a resting order
+};
+
+/**
+ * @brief One request waiting in the ingress queue or a pipeline slot
+ */
+struct OrderRequest {
+    OrderRequestType type = OrderRequestType::NEW;
+    std::shared_ptr<Order> order;      // NEW only
+    Order::OrderId orderId = 0;        // CANCEL and REDUCE: the resting order
+    Order::Quantity quantity = 0;      // REDUCE: quantity to take off
+    Order::InstrumentId instrument = 0;
+    
+    static OrderRequest newOrder(std::shared_ptr<Order> order) {
+        OrderRequest request;
+        request.orderId = order->getId();
+        request.instrument = order->getInstrument();
+        request.order = std::move(order);
+        return request;
+    }
+    
+    static OrderRequest cancel(Order::OrderId orderId, Order::InstrumentId instrument) {
+        OrderRequest request;
+        request.type = OrderRequestType::CANCEL;
+        request.orderId = orderId;
+        request.instrument = instrument;
+        return request;
+    }
+    
+    static OrderRequest reduce(Order::OrderId orderId, Order::Quantity quantity, Order::InstrumentId instrument) {
+        OrderRequest request = cancel(orderId, instrument);
+        request.type = OrderRequestType::REDUCE;
+        request.quantity = quantity;
+        return request;
+    }
+};
+
+} // namespace engine
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Order.hpp"
+#include "TickTable.hpp"
+#include "engine/util/ExactDivisor.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief Static reference data of one instrument
+ */
+struct InstrumentSpec {
+    Order::Price tickSize = 0.0001;  // Limit prices must be a multiple of this (a whole number of price ticks)
+    std::vector<TickBand> tickBands; // Price-banded tick sizes; when set, used instead of tickSize
+    Order::Quantity lotSize = 1;     // Quantities must be a multiple of this
+    Order::Quantity minQuantity = 1;
+    Order::Quantity maxQuantity = std::numeric_limits<Order::Quantity>::max();
+    Order::Price minPrice = 0.0001;  // Limit prices outside [minPrice, maxPrice] are rejected
+    Order::Price maxPrice = std::numeric_limits<Order::PriceTicks>::max() / Order::kTicksPerUnit;
+};
+
+/**
+ * @brief Why the validator turned an order away
+ *
+ * When an order breaks several rules, the first reason in this order is reported.
+ */
+enum class ValidationRejectReason : std::uint8_t {
+    NONE,                // Accepted
+    UNKNOWN_INSTRUMENT,  // No reference data for the instrument
+    INVALID_PRICE,       // Limit price that is not a positive number
+    QUANTITY_RANGE,      // Quantity outside [minQuantity, maxQuantity], including zero
+    LOT_SIZE,            // Quantity not a multiple of the lot size
+    TICK_SIZE,           // Limit price not on the tick grid of its price band
+    PRICE_RANGE,         // Limit price outside [minPrice, maxPrice]
+    COUNT
+};
+
+/**
+ * @brief Get the name of a validation reject reason
+ */
+const char* toString(ValidationRejectReason reason);
+
+/**
+ * @brief Table-driven static order validation against per-instrument reference data
+ *
+ * The reference data is converted once into a dense array of small records
+ * indexed by instrument ID, holding integer bounds and the lot size as a
+ * util::ExactDivisor, plus a TickTable per instrument. A multiple-of check is
+ * then a multiply, a rotate and a compare instead of a division. validate() runs
+ * every rule as straight-line code into a bit mask and branches once on the
+ * result, so the cost of an accepted order does not depend on the data.
+ *
+ * Thread-safe: the table is read-only after construction, and only rejects
+ * touch the (relaxed, atomic) counters.
+ */
+class OrderValidator {
+public:
+    /**
+     * @brief Create a validator
+     *
+     * @param specs Reference data per instrument ID [0, specs.size())
+     * @throws std::invalid_argument if a spec is inconsistent or its tick sizes do not form a valid TickTable
+     */
+    explicit OrderValidator(const std::vector<InstrumentSpec>& specs);
+
+    /**
+     * @brief Check an order against its instrument's reference data
+     *
+     * Market orders are checked for quantity only.
+     */
+    ValidationRejectReason validate(const Order& order) const {
+        Order::InstrumentId instrument = order.getInstrument();
+        if (instrument >= rules_.size()) {
+            return reject(ValidationRejectReason::UNKNOWN_INSTRUMENT);
+        }
+        const Rules& rules = rules_[instrument];
+        const TickTable& ticks = tickTables_[instrument];
+
+        Order::Quantity quantity = order.getQuantity();
+        Order::Price price = order.getPrice();
+        bool limit = order.getType() == OrderType::LIMIT;
+        bool priceValid = price > 0 && price <= kMaxPrice;  // Also false for NaN
+        Order::PriceTicks priceTicks = Order::toTicks(priceValid ? price : 0.0);
+        bool checkPrice = limit && priceValid;
+
+        std::uint32_t failures =
+            bit(limit && !priceValid, ValidationRejectReason::INVALID_PRICE) |
+            bit(quantity < rules.minQuantity || quantity > rules.maxQuantity, ValidationRejectReason::QUANTITY_RANGE) |
+            bit(!rules.lot.divides(quantity), ValidationRejectReason::LOT_SIZE) |
+            bit(checkPrice && !ticks.isValid(priceTicks), ValidationRejectReason::TICK_SIZE) |
+            bit(checkPrice && (priceTicks < rules.minPrice || priceTicks > rules.maxPrice),
+                ValidationRejectReason::PRICE_RANGE);
+
+        if (failures == 0) {
+            return ValidationRejectReason::NONE;
+        }
+        std::size_t first = 0;
+        while ((failures & (1u << first)) == 0) {
+            ++first;
+        }
+        return reject(static_cast<ValidationRejectReason>(first));
+    }
+
+    /**
+     * @brief Number of orders rejected for a reason
+     */
+    std::uint64_t rejectedOrders(ValidationRejectReason reason) const {
+        return rejected_[static_cast<std::size_t>(reason)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of instruments with reference data
+     */
+    std::size_t getNumInstruments() const { return specs_.size(); }
+
+    /**
+     * @brief Get the reference data of an instrument
+     *
+     * @throws std::out_of_range if the instrument has none
+     */
+    const InstrumentSpec& getSpec(Order::InstrumentId instrument) const { return specs_.at(instrument); }
+    
+    /**
+     * @brief Get the tick table of an instrument, built from tickBands or tickSize
+     * 
+     * @throws std::out_of_range if the instrument has none
+     */
+    const TickTable& getTickTable(Order::InstrumentId instrument) const { return tickTables_.at(instrument); }
+
+    // Delete copy constructor/assignment
+    OrderValidator(const OrderValidator&) = delete;
+    OrderValidator& operator=(const OrderValidator&) = delete;
+
+private:
+    // Largest limit price that still fits in PriceTicks
+    static constexpr Order::Price kMaxPrice = std::numeric_limits<Order::PriceTicks>::max() / Order::kTicksPerUnit;
+
+    /**
+     * @brief One instrument's rules as integers
+     */
+    struct Rules {
+        util::ExactDivisor<std::uint64_t> lot;
+        Order::Quantity minQuantity;
+        Order::Quantity maxQuantity;
+        Order::PriceTicks minPrice;
+        Order::PriceTicks maxPrice;
+    };
+
+    static_assert(sizeof(Rules) == 56, "Validation rules must stay at 56 bytes");
+
+    static std::uint32_t bit(bool failed, ValidationRejectReason reason) {
+        return static_cast<std::uint32_t>(failed) << static_cast<unsigned>(reason);
+    }
+
+    ValidationRejectReason reject(ValidationRejectReason reason) const {
+        rejected_[static_cast<std::size_t>(reason)].fetch_add(1, std::memory_order_relaxed);
+        return reason;
+    }
+
+    std::vector<InstrumentSpec> specs_;
+    std::vector<Rules> rules_;
+    std::vector<TickTable> tickTables_;
+    mutable std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(ValidationRejectReason::COUNT)> rejected_{};
+};
+
+} // namespace engine
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Order.hpp"
+#include "Trade.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief Consistent view of one account's position in one instrument
+ */
+struct PositionSnapshot {
+    Order::AccountId account;
+    Order::InstrumentId instrument;
+    std::int64_t netPosition;      // Positive is long
+    double averagePrice;           // Average cost of the open position; 0 when flat
+    double realizedPnl;            // From closing trades, at average cost
+    double unrealizedPnl;          // Open position marked to the instrument's last trade
+    Order::Quantity volume;        // Quantity traded, both sides
+    double lastPrice;              // Last trade price of the instrument; 0 before the first trade
+};
+
+/**
+ * @brief Per-account positions and P&L maintained from the fill stream
+ *
+ * Cells are laid out densely by account, then instrument, and hold integers
+ * only: position, cost of the open position and realized P&L in price ticks x
+ * quantity, and volume. Each fill updates the two cells it touches and the
+ * instrument's last price in O(1).
+ *
+ * One thread applies fills (the engine runs it as a fan-out subscriber, off
+ * the match path). Each cell is a seqlock: the writer makes the sequence odd
+ * while it updates the cell, and readers retry until they copy it with an even,
+ * unchanged sequence. Snapshots can be taken at any time without stopping
+ * updates, and never see half of a fill.
+ */
+class PositionKeeper {
+public:
+    /**
+     * @brief Create a keeper with every position flat
+     *
+     * @param numAccounts Accounts [0, numAccounts) to track
+     * @param numInstruments Instruments [0, numInstruments) to track
+     */
+    PositionKeeper(std::size_t numAccounts, std::size_t numInstruments);
+
+    /**
+     * @brief Apply a fill to the buyer's and the seller's positions
+     *
+     * Must be called from one thread at a time. Fills for untracked accounts
+     * or instruments are counted and ignored.
+     */
+    void onFill(const Fill& fill);
+
+    /**
+     * @brief Read one position without blocking the writer
+     *
+     * Thread-safe.
+     *
+     * @throws std::out_of_range if the account or instrument is not tracked
+     */
+    PositionSnapshot getPosition(Order::AccountId account, Order::InstrumentId instrument) const;
+
+    /**
+     * @brief Read every instrument position of an account
+     *
+     * Thread-safe. Each position is consistent on its own; positions taken
+     * while fills arrive may reflect different numbers of fills.
+     */
+    std::vector<PositionSnapshot> getAccountPositions(Order::AccountId account) const;
+
+    /**
+     * @brief Number of fills applied so far
+     */
+    std::uint64_t appliedFills() const { return appliedFills_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of fills ignored because an account or instrument is not tracked
+     */
+    std::uint64_t ignoredFills() const { return ignoredFills_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of times a reader copied a cell that was being written and retried
+     */
+    std::uint64_t snapshotRetries() const { return snapshotRetries_.load(std::memory_order_relaxed); }
+
+    std::size_t getNumAccounts() const { return numAccounts_; }
+    std::size_t getNumInstruments() const { return numInstruments_; }
+
+    // Delete copy constructor/assignment
+    PositionKeeper(const PositionKeeper&) = delete;
+    PositionKeeper& operator=(const PositionKeeper&) = delete;
+
+private:
+    /**
+     * @brief Position of one account in one instrument, guarded by a sequence
+     */
+    struct Cell {
+        std::atomic<std::uint32_t> sequence{0};   // Odd while the writer updates the cell
+        std::atomic<std::int64_t> position{0};
+        std::atomic<std::int64_t> cost{0};        // Ticks x quantity paid for the open position (negative if short)
+        std::atomic<std::int64_t> realized{0};    // Ticks x quantity
+        std::atomic<std::uint64_t> volume{0};
+    };
+
+    Cell& cell(Order::AccountId account, Order::InstrumentId instrument) {
+        return cells_[static_cast<std::size_t>(account) * numInstruments_ + instrument];
+    }
+
+    /**
+     * @brief Apply a signed quantity at a price to one cell (single writer)
+     */
+    void apply(Cell& cell, std::int64_t quantity, Order::PriceTicks price);
+
+    const std::size_t numAccounts_;
+    const std::size_t numInstruments_;
+    std::vector<Cell> cells_;
+    std::vector<std::atomic<Order::PriceTicks>> lastPrices_;
+
+    std::atomic<std::uint64_t> appliedFills_{0};
+    std::atomic<std::uint64_t> ignoredFills_{0};
+    mutable std::atomic<std::uint64_t> snapshotRetries_{0};
+};
+
+} // namespace engine
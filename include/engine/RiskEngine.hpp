@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Order.hpp"
+#include "Trade.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief Pre-trade limits applied to every account
+ */
+struct RiskLimits {
+    Order::Quantity maxOrderQuantity = 10000;   // Largest quantity of a single order
+    double maxOrderNotional = 1000000.0;        // Largest quantity x price of a single order
+    double maxOpenNotional = 10000000.0;        // Largest notional of an account's open limit orders
+    std::int64_t maxPosition = 100000;          // Largest absolute net position per instrument
+    double priceBand = 0.10;                    // Limit prices must be within this fraction of the last trade
+};
+
+/**
+ * @brief Why the risk engine turned an order away
+ */
+enum class RiskRejectReason : std::uint8_t {
+    NONE,               // Accepted
+    UNKNOWN_ACCOUNT,    // Account or instrument outside the configured range
+    INVALID_ORDER,      // Zero quantity, or a limit price that is not a positive number
+    ORDER_QUANTITY,     // Quantity above maxOrderQuantity
+    ORDER_NOTIONAL,     // Notional above maxOrderNotional
+    PRICE_BAND,         // Limit price too far from the last trade (fat finger)
+    POSITION,           // A full fill would take the position past maxPosition
+    OPEN_NOTIONAL,      // The account's open orders would exceed maxOpenNotional
+    COUNT
+};
+
+/**
+ * @brief Get the name of a reject reason
+ */
+const char* toString(RiskRejectReason reason);
+
+/**
+ * @brief Pre-trade risk checks with lock-free per-account state
+ *
+ * check() runs on the submitting (gateway) thread, before an order is queued,
+ * or in the pipeline's risk stage. It touches only a few atomics: the last
+ * trade price of the instrument, the account's position in it and the
+ * account's open notional. Open notional is reserved with one atomic add and
+ * given back if it overshoots the limit, so concurrent gateways never take a
+ * lock and never exceed the limit together.
+ *
+ * State is kept in dense arrays indexed by account (and account x instrument
+ * for positions), with all amounts as integers: notionals in price ticks x
+ * quantity. Positions and last prices are updated from fills; open notional is
+ * given back as orders fill, are canceled, or leave the book unfilled.
+ *
+ * Market orders are checked for notional at the last trade price, but hold no
+ * open notional because they never rest.
+ */
+class RiskEngine {
+public:
+    /**
+     * @brief Create a risk engine
+     *
+     * @param numAccounts Accounts [0, numAccounts) that may trade
+     * @param numInstruments Instruments [0, numInstruments) that may be traded
+     * @param limits Limits applied to every account
+     */
+    RiskEngine(std::size_t numAccounts, std::size_t numInstruments, const RiskLimits& limits = RiskLimits());
+
+    /**
+     * @brief Check an order and reserve its open notional if it passes
+     *
+     * Thread-safe and lock-free. Every accepted limit order must later be
+     * released through onOrderMatched, onFill, or onOrderRemoved.
+     *
+     * @param order The order to check
+     * @return RiskRejectReason NONE if the order was accepted
+     */
+    RiskRejectReason check(const Order& order);
+
+    /**
+     * @brief Release what an accepted order filled while it was the aggressor, or in an auction
+     *
+     * @param order The order after matching
+     * @param filledQuantity Quantity it filled on entry or in the auction
+     */
+    void onOrderMatched(const Order& order, Order::Quantity filledQuantity) {
+        if (order.getType() == OrderType::LIMIT && filledQuantity > 0) {
+            release(order.getAccount(), notional(Order::toTicks(order.getPrice()), filledQuantity));
+        }
+    }
+
+    /**
+     * @brief Update positions and the last price, and release the resting side of a fill
+     *
+     * Auction trades have no resting side; both orders are released through onOrderMatched.
+     */
+    void onFill(const Fill& fill);
+
+    /**
+     * @brief Release open quantity taken off the book by a cancel or reduce
+     */
+    void onOrderRemoved(const Order& order, Order::Quantity removedQuantity) {
+        if (order.getType() == OrderType::LIMIT && removedQuantity > 0) {
+            release(order.getAccount(), notional(Order::toTicks(order.getPrice()), removedQuantity));
+        }
+    }
+
+    /**
+     * @brief Net position of an account in an instrument (positive is long)
+     */
+    std::int64_t getPosition(Order::AccountId account, Order::InstrumentId instrument) const {
+        return positions_[positionIndex(account, instrument)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Open notional of an account, in price units
+     */
+    double getOpenNotional(Order::AccountId account) const {
+        return openNotional_[account].load(std::memory_order_relaxed) / Order::kTicksPerUnit;
+    }
+
+    /**
+     * @brief Number of orders checked so far
+     */
+    std::uint64_t checkedOrders() const { return checked_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of orders rejected for a reason
+     */
+    std::uint64_t rejectedOrders(RiskRejectReason reason) const {
+        return rejected_[static_cast<std::size_t>(reason)].load(std::memory_order_relaxed);
+    }
+
+    std::size_t getNumAccounts() const { return openNotional_.size(); }
+    const RiskLimits& getLimits() const { return limits_; }
+
+    // Delete copy constructor/assignment
+    RiskEngine(const RiskEngine&) = delete;
+    RiskEngine& operator=(const RiskEngine&) = delete;
+
+private:
+    static std::int64_t notional(Order::PriceTicks price, Order::Quantity quantity) {
+        return static_cast<std::int64_t>(price) * static_cast<std::int64_t>(quantity);
+    }
+
+    std::size_t positionIndex(Order::AccountId account, Order::InstrumentId instrument) const {
+        return static_cast<std::size_t>(account) * numInstruments_ + instrument;
+    }
+
+    void release(Order::AccountId account, std::int64_t amount) {
+        openNotional_[account].fetch_sub(amount, std::memory_order_relaxed);
+    }
+
+    RiskRejectReason reject(RiskRejectReason reason) {
+        rejected_[static_cast<std::size_t>(reason)].fetch_add(1, std::memory_order_relaxed);
+        return reason;
+    }
+
+    const RiskLimits limits_;
+    const std::size_t numInstruments_;
+
+    // Limits converted to ticks once, so checks compare integers
+    const std::int64_t maxOrderNotionalTicks_;
+    const std::int64_t maxOpenNotionalTicks_;
+    const std::int64_t priceBandPpm_;
+
+    std::vector<std::atomic<std::int64_t>> openNotional_;      // Per account, in ticks x quantity
+    std::vector<std::atomic<std::int64_t>> positions_;         // Per account x instrument
+    std::vector<std::atomic<Order::PriceTicks>> lastPrices_;   // Per instrument; 0 until the first trade
+
+    std::atomic<std::uint64_t> checked_{0};
+    std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(RiskRejectReason::COUNT)> rejected_{};
+};
+
+} // namespace engine
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Order.hpp"
+#include "Trade.hpp"
+#include "FanOutRing.hpp"
+#include "RiskEngine.hpp"
+#include "engine/util/AsyncLogger.hpp"
+#include <functional>
+
+namespace engine {
+
+/**
+ * @brief Logs every trade through the asynchronous logger
+ */
+struct TradeLogSubscriber {
+    bool enabled = true;
+    
+    void onTrade(const Trade& trade) {
+        if (enabled) {
+            util::AsyncLogger::getInstance().log("TRADE EXECUTED: {}", trade);
+        }
+    }
+};
+
+/**
+ * @brief Forwards events to callbacks registered at run time
+ * 
+ * The one subscriber that pays for type erasure, and only while a callback is set.
+ */
+struct CallbackSubscriber {
+    std::function<void(const Trade&)> tradeCallback;
+    std::function<void(const Order&)> orderCallback;
+    
+    void onTrade(const Trade& trade) {
+        if (tradeCallback) {
+            tradeCallback(trade);
+        }
+    }
+    
+    void onOrderProcessed(const Order& order) {
+        if (orderCallback) {
+            orderCallback(order);
+        }
+    }
+};
+
+/**
+ * @brief Writes trades and order updates to the fan-out ring, if one is attached
+ */
+struct FanOutPublisher {
+    FanOutRing* ring = nullptr;
+    
+    void onFill(const Fill& fill) {
+        if (ring) {
+            ring->publish(EngineEvent(fill));
+        }
+    }
+    
+    void onOrderProcessed(const Order& order) {
+        if (ring) {
+            ring->publish(EngineEvent(OrderUpdate{order.getId(), order.getRemainingQuantity(),
+                                                  Order::toTicks(order.getPrice()), order.getInstrument(),
+                                                  order.getSide(), order.getStatus()}));
+        }
+    }
+};
+
+/**
+ * @brief Feeds fills back into the pre-trade risk engine, if one is configured
+ */
+struct RiskSubscriber {
+    RiskEngine* risk = nullptr;
+    
+    void onFill(const Fill& fill) {
+        if (risk) {
+            risk->onFill(fill);
+        }
+    }
+};
+
+} // namespace engine
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Order.hpp"
+#include "engine/util/ExactDivisor.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief One band of a tick table: the tick size that applies from a price up to the next band
+ */
+struct TickBand {
+    Order::Price from;      // Lowest price of the band; the first band's is the lowest valid price
+    Order::Price tickSize;  // Price increment within the band
+};
+
+/**
+ * @brief Piecewise tick-size regime, mapping valid prices to dense level indices
+ *
+ * Prices on the grid are numbered from 0 at the first band's lowest price,
+ * and the numbering continues across band boundaries without gaps, so level
+ * arrays indexed by it stay dense. Each boundary must lie on the grid of the
+ * band below it.
+ *
+ * The band of a price is found by comparing it against every band start at
+ * once (at most kMaxBands, unused ones never match), so there is no search
+ * loop; the level within the band is an exact division by the band's tick
+ * using a precomputed inverse. Both directions are constant time.
+ */
+class TickTable {
+public:
+    static constexpr std::size_t kMaxBands = 8;
+
+    using Level = std::uint32_t;
+
+    /**
+     * @brief A single band with a tick of one price tick from the smallest positive price
+     */
+    TickTable();
+
+    /**
+     * @brief Build a table from bands in ascending price order
+     *
+     * @throws std::invalid_argument if there are no bands or more than kMaxBands, if the bands are not
+     *         ascending, if a tick is not a whole number of price ticks, or if a boundary is off the grid
+     *         of the band below
+     */
+    explicit TickTable(const std::vector<TickBand>& bands);
+
+    /**
+     * @brief Check whether a price is on the grid
+     */
+    bool isValid(Order::PriceTicks price) const {
+        std::size_t band = bandOf(price);
+        return price >= starts_[0] && ticks_[band].divides(static_cast<std::uint32_t>(price - starts_[band]));
+    }
+
+    /**
+     * @brief Level index of a price on the grid; the result is meaningless for other prices
+     */
+    Level levelOf(Order::PriceTicks price) const {
+        std::size_t band = bandOf(price);
+        return levels_[band] + ticks_[band].divide(static_cast<std::uint32_t>(price - starts_[band]));
+    }
+
+    /**
+     * @brief Price of a level index
+     */
+    Order::PriceTicks priceOf(Level level) const {
+        std::size_t band = 0;
+        for (std::size_t i = 1; i < kMaxBands; ++i) {
+            band += level >= levels_[i];
+        }
+        return static_cast<Order::PriceTicks>(starts_[band] + (level - levels_[band]) * ticks_[band].getDivisor());
+    }
+
+    /**
+     * @brief Tick size that applies at a price, in price ticks
+     */
+    Order::PriceTicks tickAt(Order::PriceTicks price) const {
+        return static_cast<Order::PriceTicks>(ticks_[bandOf(price)].getDivisor());
+    }
+
+    /**
+     * @brief Number of bands
+     */
+    std::size_t size() const { return numBands_; }
+
+    /**
+     * @brief Number of valid prices up to the largest representable price
+     */
+    Level numLevels() const { return numLevels_; }
+
+    /**
+     * @brief Get the bands the table was built from
+     */
+    std::vector<TickBand> getBands() const;
+
+private:
+    std::size_t bandOf(Order::PriceTicks price) const {
+        std::size_t band = 0;
+        for (std::size_t i = 1; i < kMaxBands; ++i) {
+            band += price >= starts_[i];
+        }
+        return band;
+    }
+
+    // Band starts and first levels sit in their own arrays, so a lookup compares within one cache line.
+    // Unused bands start above every price and level, so the comparisons never select them.
+    std::array<std::int64_t, kMaxBands> starts_;  // Wider than PriceTicks, so an unused band can start above every price
+    std::array<Level, kMaxBands> levels_;
+    std::array<util::ExactDivisor<std::uint32_t>, kMaxBands> ticks_;
+    std::size_t numBands_ = 0;
+    Level numLevels_ = 0;
+};
+
+} // namespace engine
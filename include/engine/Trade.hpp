@@ -1,45 +1,109 @@
 #pragma once
 
 #include "Order.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace engine {
 
 /**
  * @brief Represents a trade resulting from matched orders
+ * 
+ * Packed into 32 bytes so that two trades share a cache line when they are
+ * copied into result vectors and passed through callbacks. Prices are integer
+ * ticks. The trade ID is a per-book sequence number, so (instrument, trade ID)
+ * is unique across the engine.
+ * 
+ * A trade carries no timestamp: with two 64-bit order IDs and the trade ID
+ * there is no room for one in 32 bytes. No clock is read per trade either;
+ * Fill carries the time of the order or auction that produced it.
  */
 class Trade {
 public:
+    using TradeId = std::uint32_t;
+    using TradeQuantity = std::uint32_t;
+    
+    // Largest quantity a single trade record can carry; bigger fills are split
+    static constexpr Order::Quantity kMaxQuantity = std::numeric_limits<TradeQuantity>::max();
+    
     /**
      * @brief Create a new trade from matched buy and sell orders
      * 
+     * @param tradeId Per-book trade sequence number
      * @param buyOrderId ID of buy order
      * @param sellOrderId ID of sell order
-     * @param price Execution price
-     * @param quantity Executed quantity
+     * @param price Execution price in ticks
+     * @param quantity Executed quantity (at most kMaxQuantity)
+     * @param instrument Instrument the trade happened on
+     * @param aggressorSide Side of the inbound order that took liquidity
+     *                      (in an auction, the side of the newer order)
+     * @param auction True if the trade was printed by an auction uncross
      */
-    Trade(Order::OrderId buyOrderId, Order::OrderId sellOrderId, 
-          Order::Price price, Order::Quantity quantity);
+    Trade(TradeId tradeId, Order::OrderId buyOrderId, Order::OrderId sellOrderId,
+          Order::PriceTicks price, Order::Quantity quantity,
+          Order::InstrumentId instrument, OrderSide aggressorSide, bool auction = false);
     
     // Getters
+    TradeId getTradeId() const { return tradeId_; }
     Order::OrderId getBuyOrderId() const { return buyOrderId_; }
     Order::OrderId getSellOrderId() const { return sellOrderId_; }
-    Order::Price getPrice() const { return price_; }
+    Order::PriceTicks getPriceTicks() const { return price_; }
+    Order::Price getPrice() const { return Order::fromTicks(price_); }
     Order::Quantity getQuantity() const { return quantity_; }
-    Order::TimeStamp getTimestamp() const { return timestamp_; }
+    Order::InstrumentId getInstrument() const { return instrument_; }
+    OrderSide getAggressorSide() const { return static_cast<OrderSide>(aggressorSide_); }
+    bool isAuction() const { return auction_ != 0; }
     
     /**
      * @brief String representation of the trade
      */
     std::string toString() const;
+    
+    // Buffer size that always holds the output of formatTo
+    static constexpr std::size_t kMaxFormattedLength = 128;
+    
+    /**
+     * @brief Write the toString() text into a caller-provided buffer
+     * 
+     * Allocation-free and locale-independent; the price is formatted from its
+     * integer ticks. No terminating null is written.
+     * 
+     * @param buffer Destination
+     * @param size Capacity of the buffer
+     * @return std::size_t Characters written, or 0 if the buffer was too small
+     */
+    std::size_t formatTo(char* buffer, std::size_t size) const;
 
 private:
     Order::OrderId buyOrderId_;
     Order::OrderId sellOrderId_;
-    Order::Price price_;
-    Order::Quantity quantity_;
-    Order::TimeStamp timestamp_;
+    Order::PriceTicks price_;
+    TradeQuantity quantity_;
+    TradeId tradeId_;
+    std::uint16_t instrument_;
+    std::uint8_t aggressorSide_;
+    std::uint8_t auction_;
+};
+
+static_assert(sizeof(Trade) == 32, "Trade must stay at 32 bytes");
+
+/**
+ * @brief A trade together with the accounts on both sides and the time it happened
+ * 
+ * Accounts and time are kept out of Trade so the trade record stays at 32
+ * bytes; a fill is only built on the way to event subscribers that need them,
+ * such as risk and the trade store. The time is the inbound order's timestamp,
+ * or for an auction the time of the uncross, shared by all of its trades.
+ */
+struct Fill {
+    Trade trade;
+    Order::AccountId buyAccount;
+    Order::AccountId sellAccount;
+    Order::TimeStamp timestamp;
 };
 
 } // namespace engine
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Trade.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief Output format of the trade exporter
+ */
+enum class TradeExportFormat {
+    CSV,        // Header line, then one comma-separated line per trade
+    JSON_LINES  // One JSON object per line
+};
+
+/**
+ * @brief Bulk exporter that writes trade batches as CSV or JSON lines
+ * 
+ * Trades are formatted straight into a large output buffer with integer
+ * formatting (prices from their ticks, with all 4 decimals) and the buffer is
+ * handed to the stream in one unformatted write when it fills up, so exporting
+ * costs no allocation or locale work per trade.
+ */
+class TradeExporter {
+public:
+    static constexpr std::size_t kDefaultBufferBytes = 1 << 20;
+    
+    /**
+     * @brief Create an exporter writing to a stream
+     * 
+     * The CSV header is written with the first batch.
+     * 
+     * @param out Destination stream (opened in binary mode for files)
+     * @param format CSV or JSON lines
+     * @param bufferBytes Size of the output buffer
+     */
+    TradeExporter(std::ostream& out, TradeExportFormat format, std::size_t bufferBytes = kDefaultBufferBytes);
+    
+    /**
+     * @brief Flushes any buffered output
+     */
+    ~TradeExporter();
+    
+    /**
+     * @brief Append a batch of trades
+     */
+    void write(const Trade* trades, std::size_t count);
+    
+    /**
+     * @brief Append a batch of trades
+     */
+    void write(const std::vector<Trade>& trades) { write(trades.data(), trades.size()); }
+    
+    /**
+     * @brief Hand buffered output to the stream
+     */
+    void flush();
+    
+    /**
+     * @brief Number of trades exported so far
+     */
+    std::uint64_t tradesWritten() const { return tradesWritten_; }
+    
+    /**
+     * @brief Number of bytes exported so far, including buffered output
+     */
+    std::uint64_t bytesWritten() const { return bytesFlushed_ + used_; }
+    
+    // Delete copy constructor/assignment
+    TradeExporter(const TradeExporter&) = delete;
+    TradeExporter& operator=(const TradeExporter&) = delete;
+
+private:
+    // Longest line a single trade can produce in either format
+    static constexpr std::size_t kMaxLineBytes = 256;
+    
+    std::size_t formatCsv(const Trade& trade, char* buffer);
+    std::size_t formatJson(const Trade& trade, char* buffer);
+    
+    std::ostream& out_;
+    TradeExportFormat format_;
+    std::vector<char> buffer_;
+    std::size_t used_ = 0;
+    bool headerWritten_ = false;
+    std::uint64_t tradesWritten_ = 0;
+    std::uint64_t bytesFlushed_ = 0;
+};
+
+} // namespace engine
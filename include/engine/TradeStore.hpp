@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Order.hpp"
+#include "Trade.hpp"
+#include "engine/util/MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace engine {
+
+/**
+ * @brief Fixed-size binary record of a fill in the trade store
+ */
+struct TradeStoreRecord {
+    std::int64_t timestampNanoseconds;  // Trade time since the epoch
+    Order::OrderId buyOrderId;
+    Order::OrderId sellOrderId;
+    Order::AccountId buyAccount;
+    Order::AccountId sellAccount;
+    Order::PriceTicks price;
+    std::uint32_t quantity;
+    std::uint32_t tradeId;
+    std::uint16_t instrument;
+    std::uint8_t aggressorSide;
+    std::uint8_t reserved;
+};
+
+static_assert(sizeof(TradeStoreRecord) == 48, "Trade store records must stay at 48 bytes");
+
+/**
+ * @brief Append-only binary file of the day's fills
+ *
+ * Written by the engine when MatchingEngineConfig::tradeStorePath is set, and
+ * read back by batch jobs such as end-of-day netting. Records are appended to
+ * a large stdio buffer, like the order journal.
+ *
+ * The engine appends from a fan-out subscriber thread, so nothing here
+ * throws once the file is open. The first write error is logged and disables
+ * the store: the records buffered since the last successful flush and every
+ * fill appended afterwards are counted as lost.
+ */
+class TradeStoreWriter {
+public:
+    /**
+     * @brief Open a trade store file, truncating it
+     *
+     * @param path File to write
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    explicit TradeStoreWriter(const std::string& path);
+
+    /**
+     * @brief Closes the file unless close() was called; a failed final flush is logged
+     */
+    ~TradeStoreWriter();
+
+    /**
+     * @brief Append a fill to the store
+     *
+     * @return false if the record was lost
+     */
+    bool append(const Fill& fill);
+
+    /**
+     * @brief Hand buffered records to the kernel
+     *
+     * @return false if the store is disabled
+     */
+    bool flush();
+
+    /**
+     * @brief Flush and close the file
+     *
+     * @return false if any record was lost, including in the final flush
+     */
+    bool close();
+
+    /**
+     * @brief Number of records appended and not lost so far
+     */
+    std::uint64_t recordsWritten() const { return recordsWritten_; }
+
+    /**
+     * @brief Number of records lost to a write error
+     */
+    std::uint64_t recordsLost() const { return recordsLost_; }
+
+    /**
+     * @brief Check whether a write error has disabled the store
+     */
+    bool failed() const { return failed_; }
+
+    /**
+     * @brief Bytes held by the stdio buffer; none once the file is closed
+     */
+    std::size_t memoryBytes() const { return file_ ? kBufferBytes : 0; }
+
+    // Delete copy constructor/assignment
+    TradeStoreWriter(const TradeStoreWriter&) = delete;
+    TradeStoreWriter& operator=(const TradeStoreWriter&) = delete;
+
+private:
+    static constexpr std::size_t kBufferBytes = 1 << 20;
+
+    /**
+     * @brief Disable the store and count the records that never reached the kernel
+     */
+    void fail();
+
+    std::FILE* file_;
+    std::uint64_t recordsWritten_ = 0;
+    std::uint64_t recordsLost_ = 0;
+    std::uint64_t recordsBuffered_ = 0;  // Appended since the last successful flush
+    bool failed_ = false;
+};
+
+/**
+ * @brief Read-only view of a trade store file, mapped into memory
+ */
+class TradeStoreReader {
+public:
+    /**
+     * @brief Map a trade store file
+     *
+     * @param path File to read
+     * @throws std::runtime_error if the file cannot be mapped or is not a whole number of records
+     */
+    explicit TradeStoreReader(const std::string& path);
+
+    const TradeStoreRecord* records() const {
+        return reinterpret_cast<const TradeStoreRecord*>(file_.data());
+    }
+
+    std::size_t size() const { return file_.size() / sizeof(TradeStoreRecord); }
+
+    std::size_t fileSize() const { return file_.size(); }
+
+private:
+    util::MappedFile file_;
+};
+
+} // namespace engine
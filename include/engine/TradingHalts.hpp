@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Order.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief Halt flags per instrument and per account, flipped by an admin thread
+ *
+ * Orders are checked against the flags as they enter a book. Besides one flag
+ * per instrument and per account there is a count of the flags currently set,
+ * and blocks() reads only that count while nothing is halted, so outside an
+ * incident the check is one relaxed load and a branch that is never taken.
+ * Setting a flag raises the count after the flag is stored, so an order that
+ * sees the count also sees the flag.
+ *
+ * Halts block new orders only; cancels and reductions are not checked.
+ *
+ * Thread-safe and lock-free.
+ */
+class TradingHalts {
+public:
+    /**
+     * @brief Create a table with nothing halted
+     *
+     * @param numInstruments Instruments [0, numInstruments) that can be halted
+     * @param numAccounts Accounts [0, numAccounts) that can be halted
+     */
+    TradingHalts(std::size_t numInstruments, std::size_t numAccounts);
+
+    /**
+     * @brief Check whether an order must be turned away because its instrument or account is halted
+     *
+     * Orders outside the configured ranges are never blocked here.
+     */
+    bool blocks(const Order& order) const {
+        if (active_.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        return isHalted(order);
+    }
+
+    /**
+     * @brief Halt or resume an instrument
+     *
+     * @return true if the flag changed
+     * @throws std::out_of_range if the instrument is outside the table
+     */
+    bool setInstrumentHalted(Order::InstrumentId instrument, bool halted);
+
+    /**
+     * @brief Halt or resume an account
+     *
+     * @return true if the flag changed
+     * @throws std::out_of_range if the account is outside the table
+     */
+    bool setAccountHalted(Order::AccountId account, bool halted);
+
+    bool isInstrumentHalted(Order::InstrumentId instrument) const {
+        return instrument < instruments_.size() && instruments_[instrument].load(std::memory_order_acquire) != 0;
+    }
+
+    bool isAccountHalted(Order::AccountId account) const {
+        return account < accounts_.size() && accounts_[account].load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * @brief Number of orders turned away by a halt
+     */
+    std::uint64_t blockedOrders() const { return blocked_.load(std::memory_order_relaxed); }
+
+    std::size_t getNumInstruments() const { return instruments_.size(); }
+    std::size_t getNumAccounts() const { return accounts_.size(); }
+
+    // Delete copy constructor/assignment
+    TradingHalts(const TradingHalts&) = delete;
+    TradingHalts& operator=(const TradingHalts&) = delete;
+
+private:
+    /**
+     * @brief Look up the order's flags once a halt is active; kept out of line so blocks() stays small
+     */
+    bool isHalted(const Order& order) const;
+
+    bool setFlag(std::atomic<std::uint8_t>& flag, bool halted);
+
+    std::atomic<std::uint32_t> active_{0};  // Flags currently set, over both tables
+    std::vector<std::atomic<std::uint8_t>> instruments_;
+    std::vector<std::atomic<std::uint8_t>> accounts_;
+    mutable std::atomic<std::uint64_t> blocked_{0};
+};
+
+} // namespace engine
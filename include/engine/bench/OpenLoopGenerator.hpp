@@ -0,0 +1,71 @@
+#pragma once
+
+#include "engine/MatchingEngine.hpp"
+#include "engine/util/PerformanceTimer.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace bench {
+
+/**
+ * @brief Configuration for an open-loop load test
+ */
+struct OpenLoopConfig {
+    double startRate = 50000.0;        // First target rate (orders/sec)
+    double maxRate = 2000000.0;        // Stop stepping once this rate has been tried
+    double rateStep = 2.0;             // Multiplier applied to the rate between steps
+    double stepDurationSeconds = 0.2;  // Length of the send schedule at each rate
+    double p99LimitUs = 1000.0;        // A step with a higher p99 is considered saturated
+    double minDeliveredRatio = 0.95;   // A step completing less than this share of the target rate is saturated
+    size_t numWorkers = 1;
+    size_t numBooks = 1;
+};
+
+/**
+ * @brief Result of one open-loop step at a fixed target rate
+ */
+struct OpenLoopStepResult {
+    double targetRate = 0.0;
+    double achievedRate = 0.0;          // Orders completed per second over the whole step
+    std::uint64_t orders = 0;
+    double maxSendLagUs = 0.0;          // Worst delay of an actual send behind its scheduled time
+    util::LatencySummary latencyUs;     // Completion latency measured from the scheduled send time
+    bool saturated = false;
+};
+
+/**
+ * @brief Open-loop load generator
+ * 
+ * Sends orders on a fixed timeline: order i is due at start + i / rate no matter
+ * how quickly the engine accepted the previous one. Latency is measured from that
+ * intended send time to the order's completion, so an engine stall shows up as
+ * latency for every order scheduled during it rather than silently slowing the
+ * sender down (coordinated omission).
+ */
+class OpenLoopGenerator {
+public:
+    explicit OpenLoopGenerator(OpenLoopConfig config = {}) : config_(config) {}
+    
+    /**
+     * @brief Run one step at a fixed target rate against a fresh engine
+     * 
+     * @param rate Target rate in orders/sec
+     * @return OpenLoopStepResult Result of the step
+     */
+    OpenLoopStepResult runStep(double rate) const;
+    
+    /**
+     * @brief Step the rate up until the engine saturates
+     * 
+     * @return std::vector<OpenLoopStepResult> One result per rate tried, the last one saturated
+     *         unless maxRate was reached first
+     */
+    std::vector<OpenLoopStepResult> findSaturation() const;
+
+private:
+    OpenLoopConfig config_;
+};
+
+} // namespace bench
+} // namespace engine
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "engine/MatchingEngine.hpp"
+#include "engine/replay/ItchReader.hpp"
+#include "engine/LaneSequencer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+namespace engine {
+namespace replay {
+
+/**
+ * @brief Replay pacing mode
+ */
+enum class ReplayPace {
+    MAXIMUM,   // Replay as fast as the engine accepts messages
+    RECORDED   // Replay on the timeline given by the message timestamps
+};
+
+/**
+ * @brief Options for an ITCH replay
+ */
+struct ItchReplayOptions {
+    ReplayPace pace = ReplayPace::MAXIMUM;
+    double speed = 1.0;            // Timeline multiplier for RECORDED pace (2.0 = twice as fast)
+    std::uint16_t stockLocate = 0; // Only replay this locate, into book 0 (0 = every locate into its own book)
+    std::size_t cancelPriorityRun = 0;  // Sequence cancels ahead of adds within a timestamp, as the engine's queue does
+};
+
+/**
+ * @brief Counters collected during a replay
+ */
+struct ItchReplayStats {
+    std::uint64_t messages = 0;
+    std::uint64_t adds = 0;
+    std::uint64_t executions = 0;
+    std::uint64_t cancels = 0;
+    std::uint64_t deletes = 0;
+    std::uint64_t replaces = 0;
+    std::uint64_t unknownOrders = 0;  // Messages referring to an order that is not resting in the book
+    std::uint64_t unroutedMessages = 0;  // Messages for a locate the engine has no book for
+    std::uint64_t trades = 0;
+    std::int64_t elapsedNanoseconds = 0;
+};
+
+/**
+ * @brief Drives an ITCH message stream through a MatchingEngine
+ * 
+ * Messages are mapped onto engine operations:
+ * - Add orders become limit orders using the ITCH order reference as order ID
+ * - Executions reduce the referenced order by the executed shares and count
+ *   as a trade, so the book follows the feed even when the executed order is
+ *   not at the top of its side
+ * - Partial cancels reduce the resting order, deletes cancel it
+ * - Replaces cancel the original order and add the new one on the same side
+ * 
+ * Each stock locate is replayed into its own book, locate n into instrument
+ * n - 1, so different stocks never cross. Messages for a locate beyond the
+ * engine's books are skipped and counted. With ItchReplayOptions::stockLocate
+ * set, only that locate is replayed, into book 0.
+ * 
+ * Orders are applied synchronously on the calling thread so that the replay
+ * is deterministic and the book follows the feed message by message.
+ * 
+ * Messages with the same timestamp arrived together. They are sequenced by a
+ * LaneSequencer with ItchReplayOptions::cancelPriorityRun, which puts cancels
+ * and deletes ahead of the other messages within the bound, the same rule as
+ * MatchingEngineConfig::cancelPriorityRun. A cancel or delete for an order
+ * that an earlier message of the burst adds, replaces or executes stays in
+ * feed order behind it. With the default of 0 the feed order is kept.
+ */
+class ItchReplayer {
+public:
+    /**
+     * @brief Construct a replayer
+     * 
+     * @param engine Engine to replay into
+     * @param options Replay options
+     */
+    explicit ItchReplayer(MatchingEngine& engine, ItchReplayOptions options = {})
+        : engine_(engine), options_(options) {}
+    
+    /**
+     * @brief Replay every remaining message from the reader
+     * 
+     * @param reader Reader positioned at the first message to replay
+     * @return ItchReplayStats Counters for the replay
+     */
+    ItchReplayStats replay(ItchReader& reader);
+
+private:
+    MatchingEngine& engine_;
+    ItchReplayOptions options_;
+    
+    /**
+     * @brief Add a message to the burst, in the priority lane if it is a cancel that overtakes nothing for its order
+     * 
+     * @param waitingRefs Orders named by messages in the burst's normal lane; updated
+     */
+    void push(LaneSequencer<ItchMessage>& burst, std::unordered_set<std::uint64_t>& waitingRefs,
+              const ItchMessage& msg);
+    
+    /**
+     * @brief Apply the messages of one timestamp in the order the sequencer gives them
+     */
+    void applyBurst(LaneSequencer<ItchMessage>& burst, ItchReplayStats& stats);
+    
+    /**
+     * @brief Book a message is replayed into; false if the engine has none for its locate
+     */
+    bool route(const ItchMessage& msg, Order::InstrumentId& instrument) const;
+    
+    /**
+     * @brief Apply one decoded message to the engine
+     */
+    void apply(const ItchMessage& msg, ItchReplayStats& stats);
+};
+
+} // namespace replay
+} // namespace engine
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace engine {
+namespace util {
+
+/**
+ * @brief Asynchronous logger with per-thread binary rings
+ *
+ * A logging thread copies the format string pointer, a pointer to the
+ * formatting function for its argument types, and the raw argument bytes into
+ * a fixed 64-byte record in its own single-producer ring. No text is formatted
+ * and no lock is taken on the calling thread. A background thread drains every
+ * ring, formats the records and writes them to the output stream.
+ *
+ * Format strings use "{}" placeholders and must be string literals (only the
+ * pointer is stored). Arguments must be trivially copyable; objects with a
+ * formatTo() or toString() method are written with it, floating-point values
+ * with two decimals. When a thread's ring is full the record is dropped rather than
+ * blocking the caller, and the number of dropped records is reported in the
+ * output.
+ */
+class AsyncLogger {
+public:
+    static constexpr std::size_t kRecordBytes = 64;
+    static constexpr std::size_t kDefaultRingRecords = 8192;
+
+    /**
+     * @brief Create a logger and start its background thread
+     *
+     * @param out Stream the formatted records are written to
+     * @param ringRecords Records per thread ring (rounded up to a power of two)
+     */
+    explicit AsyncLogger(std::ostream& out = std::cout, std::size_t ringRecords = kDefaultRingRecords)
+        : out_(out), ringRecords_(roundUpToPowerOfTwo(ringRecords)), id_(nextLoggerId()) {
+        buffer_ << std::fixed << std::setprecision(2);
+        thread_ = std::thread(&AsyncLogger::run, this);
+    }
+
+    /**
+     * @brief Stop the background thread after writing every pending record
+     */
+    ~AsyncLogger() {
+        running_.store(false, std::memory_order_release);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /**
+     * @brief Get the process-wide logger writing to std::cout
+     */
+    static AsyncLogger& getInstance() {
+        static AsyncLogger instance;
+        return instance;
+    }
+
+    /**
+     * @brief Queue a record for formatting on the background thread
+     *
+     * @param format String literal with one "{}" per argument
+     * @param args Trivially copyable arguments
+     * @return true if the record was queued, false if the ring was full
+     */
+    template<typename... Args>
+    bool log(const char* format, const Args&... args) {
+        static_assert((std::is_trivially_copyable_v<Args> && ...),
+                      "Log arguments are copied as raw bytes and must be trivially copyable");
+        static_assert((std::size_t{0} + ... + sizeof(Args)) <= kPayloadBytes,
+                      "Log arguments do not fit in one record");
+
+        Ring& ring = localRing();
+        std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+        if (head - ring.tail.load(std::memory_order_acquire) > ring.mask) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Record& record = ring.records[head & ring.mask];
+        record.format = format;
+        record.formatFn = &formatRecord<Args...>;
+        unsigned char* payload = record.payload;
+        ((std::memcpy(payload, &args, sizeof(Args)), payload += sizeof(Args)), ...);
+        (void)payload;
+
+        ring.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Block until every record queued before the call has been written
+     */
+    void flush() {
+        std::vector<std::pair<std::shared_ptr<Ring>, std::uint64_t>> targets;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex_);
+            for (const auto& ring : rings_) {
+                targets.emplace_back(ring, ring->head.load(std::memory_order_acquire));
+            }
+        }
+        for (const auto& [ring, target] : targets) {
+            while (ring->tail.load(std::memory_order_acquire) < target) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+
+    /**
+     * @brief Number of records dropped because a ring was full
+     */
+    std::uint64_t droppedRecords() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of records written to the output stream
+     */
+    std::uint64_t writtenRecords() const {
+        return written_.load(std::memory_order_relaxed);
+    }
+
+    // Delete copy and move constructors/operators
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+    AsyncLogger(AsyncLogger&&) = delete;
+    AsyncLogger& operator=(AsyncLogger&&) = delete;
+
+private:
+    using FormatFn = void (*)(std::ostream&, const char*, const unsigned char*);
+
+    static constexpr std::size_t kPayloadBytes = kRecordBytes - sizeof(const char*) - sizeof(FormatFn);
+
+    struct Record {
+        const char* format;
+        FormatFn formatFn;
+        unsigned char payload[kPayloadBytes];
+    };
+
+    static_assert(sizeof(Record) == kRecordBytes, "Log records must stay at 64 bytes");
+
+    /**
+     * @brief Single-producer, single-consumer ring owned by one logging thread
+     */
+    struct Ring {
+        explicit Ring(std::size_t capacity) : records(capacity), mask(capacity - 1) {}
+
+        std::vector<Record> records;
+        const std::uint64_t mask;
+        alignas(64) std::atomic<std::uint64_t> head{0};  // Written by the logging thread
+        alignas(64) std::atomic<std::uint64_t> tail{0};  // Written by the background thread
+        std::atomic<bool> orphaned{false};               // Logging thread has exited
+    };
+
+    /**
+     * @brief Rings of the calling thread, one per logger it has used
+     */
+    struct LocalRings {
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<Ring>>> entries;
+
+        ~LocalRings() {
+            for (auto& entry : entries) {
+                entry.second->orphaned.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    template<typename T, typename = void>
+    struct HasFormatTo : std::false_type {};
+
+    template<typename T>
+    struct HasFormatTo<T, std::void_t<decltype(std::declval<const T&>().formatTo(std::declval<char*>(), std::size_t{}))>>
+        : std::true_type {};
+
+    template<typename T, typename = void>
+    struct HasToString : std::false_type {};
+
+    template<typename T>
+    struct HasToString<T, std::void_t<decltype(std::declval<const T&>().toString())>> : std::true_type {};
+
+    static std::uint64_t nextLoggerId() {
+        static std::atomic<std::uint64_t> nextId{1};
+        return nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t value) {
+        std::size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    Ring& localRing() {
+        static thread_local LocalRings local;
+        for (auto& entry : local.entries) {
+            if (entry.first == id_) {
+                return *entry.second;
+            }
+        }
+
+        // First record from this thread: register a new ring
+        auto ring = std::make_shared<Ring>(ringRecords_);
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex_);
+            rings_.push_back(ring);
+        }
+        local.entries.emplace_back(id_, ring);
+        return *ring;
+    }
+
+    template<typename T>
+    static T readArg(const unsigned char*& payload) {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::memcpy(storage, payload, sizeof(T));
+        payload += sizeof(T);
+        return *std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    template<typename T>
+    static void writeArg(std::ostream& os, const T& value) {
+        if constexpr (HasFormatTo<T>::value) {
+            char text[T::kMaxFormattedLength];
+            os.write(text, static_cast<std::streamsize>(value.formatTo(text, sizeof(text))));
+        } else if constexpr (HasToString<T>::value) {
+            os << value.toString();
+        } else if constexpr (std::is_enum_v<T>) {
+            os << static_cast<std::underlying_type_t<T>>(value);
+        } else {
+            os << value;
+        }
+    }
+
+    static void writeFormatted(std::ostream& os, const char* format) {
+        os << format;
+    }
+
+    template<typename T, typename... Rest>
+    static void writeFormatted(std::ostream& os, const char* format, const T& first, const Rest&... rest) {
+        const char* placeholder = std::strstr(format, "{}");
+        if (placeholder == nullptr) {
+            os << format;
+            return;
+        }
+        os.write(format, placeholder - format);
+        writeArg(os, first);
+        writeFormatted(os, placeholder + 2, rest...);
+    }
+
+    template<typename... Args>
+    static void formatRecord(std::ostream& os, const char* format, const unsigned char* payload) {
+        // Braced initialization reads the arguments left to right
+        std::tuple<Args...> values{readArg<Args>(payload)...};
+        (void)payload;
+        std::apply([&os, format](const Args&... args) { writeFormatted(os, format, args...); }, values);
+    }
+
+    void run() {
+        while (running_.load(std::memory_order_acquire)) {
+            if (drain() == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        drain();
+    }
+
+    /**
+     * @brief Format and write everything currently queued in every ring
+     *
+     * @return size_t Number of records written
+     */
+    std::size_t drain() {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        std::size_t total = 0;
+
+        for (auto it = rings_.begin(); it != rings_.end();) {
+            Ring& ring = **it;
+            // Read the orphaned flag first so records queued just before exit are not lost
+            bool orphaned = ring.orphaned.load(std::memory_order_acquire);
+            std::uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+            std::uint64_t head = ring.head.load(std::memory_order_acquire);
+
+            if (head != tail) {
+                buffer_.str("");
+                for (; tail != head; ++tail) {
+                    const Record& record = ring.records[tail & ring.mask];
+                    record.formatFn(buffer_, record.format, record.payload);
+                    buffer_ << '\n';
+                }
+                writeBuffer();
+                std::uint64_t count = head - ring.tail.load(std::memory_order_relaxed);
+                ring.tail.store(tail, std::memory_order_release);
+                written_.fetch_add(count, std::memory_order_relaxed);
+                total += count;
+            }
+
+            if (orphaned) {
+                it = rings_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops_) {
+            buffer_.str("");
+            buffer_ << "[log] " << (dropped - reportedDrops_) << " records dropped (ring full)\n";
+            writeBuffer();
+            reportedDrops_ = dropped;
+        }
+
+        return total;
+    }
+
+    /**
+     * @brief Write the formatting buffer to the output stream
+     *
+     * Text is formatted in a private buffer and written unformatted, so the
+     * shared stream's flags are never read or changed by this thread.
+     */
+    void writeBuffer() {
+        const std::string text = buffer_.str();
+        out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+        out_.flush();
+    }
+
+    std::ostream& out_;
+    const std::size_t ringRecords_;
+    const std::uint64_t id_;
+
+    std::mutex ringsMutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::ostringstream buffer_;
+
+    std::atomic<bool> running_{true};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> written_{0};
+    std::uint64_t reportedDrops_ = 0;
+    std::thread thread_;
+};
+
+} // namespace util
+} // namespace engine
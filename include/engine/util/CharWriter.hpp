@@ -0,0 +1,137 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace engine {
+namespace util {
+
+/**
+ * @brief Allocation-free text writer over a caller-provided buffer
+ *
+ * Numbers are written with std::to_chars, which ignores the locale and never
+ * allocates. Fixed-point values are formatted from integers, so prices held in
+ * ticks never pass through floating point. When the buffer runs out the writer
+ * stops writing and ok() turns false.
+ */
+class CharWriter {
+public:
+    /**
+     * @brief Write into [first, last)
+     */
+    CharWriter(char* first, char* last) : begin_(first), pos_(first), end_(last) {}
+
+    /**
+     * @brief Append raw text
+     */
+    CharWriter& append(std::string_view text) {
+        if (ok_ && static_cast<std::size_t>(end_ - pos_) >= text.size()) {
+            std::memcpy(pos_, text.data(), text.size());
+            pos_ += text.size();
+        } else {
+            ok_ = false;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Append a single character
+     */
+    CharWriter& append(char c) {
+        if (ok_ && pos_ != end_) {
+            *pos_++ = c;
+        } else {
+            ok_ = false;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Append an integer in decimal
+     */
+    template<typename Integer>
+    CharWriter& appendInteger(Integer value) {
+        if (ok_) {
+            auto [ptr, ec] = std::to_chars(pos_, end_, value);
+            if (ec == std::errc()) {
+                pos_ = ptr;
+            } else {
+                ok_ = false;
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Append a fixed-point value stored as an integer
+     *
+     * Rounds half away from zero when fewer decimals are shown than stored.
+     *
+     * @param value Value scaled by 10^scaleDigits (e.g. price ticks)
+     * @param scaleDigits Number of implied decimals in value
+     * @param decimals Number of decimals to write (at most scaleDigits)
+     */
+    CharWriter& appendFixed(std::int64_t value, int scaleDigits, int decimals) {
+        bool negative = value < 0;
+        std::uint64_t magnitude = negative ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+
+        std::uint64_t dropped = pow10(scaleDigits - decimals);
+        if (dropped > 1) {
+            magnitude = (magnitude + dropped / 2) / dropped;
+        }
+
+        std::uint64_t unit = pow10(decimals);
+        if (negative && magnitude != 0) {
+            append('-');
+        }
+        appendInteger(magnitude / unit);
+
+        if (decimals > 0) {
+            append('.');
+            // Fractional digits, zero-padded on the left
+            char digits[20];
+            std::uint64_t fraction = magnitude % unit;
+            for (int i = decimals - 1; i >= 0; --i) {
+                digits[i] = static_cast<char>('0' + fraction % 10);
+                fraction /= 10;
+            }
+            append(std::string_view(digits, static_cast<std::size_t>(decimals)));
+        }
+        return *this;
+    }
+
+    /**
+     * @brief False once anything failed to fit in the buffer
+     */
+    bool ok() const { return ok_; }
+
+    /**
+     * @brief Number of characters written so far
+     */
+    std::size_t size() const { return static_cast<std::size_t>(pos_ - begin_); }
+
+    /**
+     * @brief One past the last character written
+     */
+    char* position() const { return pos_; }
+
+private:
+    static std::uint64_t pow10(int exponent) {
+        std::uint64_t result = 1;
+        for (int i = 0; i < exponent; ++i) {
+            result *= 10;
+        }
+        return result;
+    }
+
+    char* begin_;
+    char* pos_;
+    char* end_;
+    bool ok_ = true;
+};
+
+} // namespace util
+} // namespace engine
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace engine {
+namespace util {
+
+/**
+ * @brief Divisibility checks and exact division by a constant, without a divide instruction
+ *
+ * The divisor d is split into odd << shift, and the odd part's inverse modulo
+ * 2^bits is precomputed. Multiplying by the inverse maps exactly the multiples
+ * of the odd part onto [0, max / odd] and turns them into their quotient;
+ * rotating right by shift then moves any low bit that a multiple of 2^shift
+ * must have clear into the top bits, which pushes the result above max / d.
+ * Both operations are a multiply, a rotate and at most one compare.
+ *
+ * @tparam T Unsigned integer type of the values
+ */
+template<typename T>
+class ExactDivisor {
+    static_assert(std::is_unsigned_v<T>, "ExactDivisor works on unsigned integers");
+
+public:
+    /**
+     * @brief Divisor 1
+     */
+    ExactDivisor() = default;
+
+    /**
+     * @brief Precompute the inverse of a divisor
+     *
+     * @throws std::invalid_argument if the divisor is zero
+     */
+    explicit ExactDivisor(T divisor)
+        : divisor_(divisor) {
+        if (divisor == 0) {
+            throw std::invalid_argument("Divisor must not be zero");
+        }
+        T odd = divisor;
+        while ((odd & 1) == 0) {
+            odd >>= 1;
+            shift_++;
+        }
+        // Newton's iteration doubles the correct low bits each step, starting from 3 (odd * odd == 1 mod 8)
+        inverse_ = odd;
+        for (int i = 0; i < 5; ++i) {
+            inverse_ = static_cast<T>(inverse_ * static_cast<T>(2 - odd * inverse_));
+        }
+        limit_ = std::numeric_limits<T>::max() / divisor;
+    }
+
+    /**
+     * @brief Check whether value is a multiple of the divisor
+     */
+    bool divides(T value) const {
+        return quotient(value) <= limit_;
+    }
+
+    /**
+     * @brief Divide a multiple of the divisor; the result is meaningless for other values
+     */
+    T divide(T value) const {
+        return quotient(value);
+    }
+
+    T getDivisor() const { return divisor_; }
+
+private:
+    static constexpr unsigned kBits = std::numeric_limits<T>::digits;
+
+    T quotient(T value) const {
+        T product = static_cast<T>(value * inverse_);
+        return static_cast<T>((product >> shift_) | (product << ((kBits - shift_) % kBits)));
+    }
+
+    T divisor_ = 1;
+    T inverse_ = 1;
+    T limit_ = std::numeric_limits<T>::max();
+    unsigned shift_ = 0;
+};
+
+} // namespace util
+} // namespace engine
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace engine {
+namespace util {
+
+/**
+ * @brief Open-addressing map from 64-bit keys to non-null pointers, for keys handed out in increasing order
+ *
+ * Slots are a flat array of key/pointer pairs, and a null pointer marks a
+ * free slot. A key's home slot is its low bits, so keys that are close
+ * together, like order IDs waiting in a FIFO, sit in neighbouring slots and
+ * inserting and erasing them walks the table sequentially instead of missing
+ * the cache on every access. Probing is linear with Robin Hood ordering: an
+ * entry never sits further from home than the ones before it, so a lookup for
+ * an absent key stops as soon as it passes where the key would be, even
+ * inside a long run of neighbours. Erasing shifts the rest of the run back
+ * instead of leaving a tombstone. The table doubles once it is half full and
+ * never shrinks.
+ *
+ * Not thread-safe.
+ *
+ * @tparam T Type the stored pointers point to
+ */
+template<typename T>
+class FlatPointerMap {
+public:
+    /**
+     * @brief Create an empty map with room for about capacity entries before it grows
+     */
+    explicit FlatPointerMap(std::size_t capacity = 1024,
+                            std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : slots_(resource) {
+        std::size_t slots = 8;
+        while (slots < capacity * 2) {
+            slots *= 2;
+        }
+        resize(slots);
+    }
+
+    /**
+     * @brief Look up a key
+     *
+     * @return T* The stored pointer, or null if the key is absent
+     */
+    T* find(std::uint64_t key) const {
+        std::size_t i = locate(key);
+        return i == kAbsent ? nullptr : slots_[i].value;
+    }
+
+    /**
+     * @brief Add a key unless it is present
+     *
+     * @param value Pointer to store; must not be null
+     * @return true if the key was added
+     */
+    bool insert(std::uint64_t key, T* value) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            resize(slots_.size() * 2);
+        }
+        // Take the slot of the first entry that is closer to home, and carry that entry on. Up to
+        // there the key would have been found if present; past it only displaced entries are placed.
+        Slot entry{key, value};
+        bool displaced = false;
+        for (std::size_t i = home(key), distance = 0;; i = (i + 1) & mask_, ++distance) {
+            Slot& slot = slots_[i];
+            if (!slot.value) {
+                slot = entry;
+                size_++;
+                return true;
+            }
+            if (!displaced && slot.key == key) {
+                return false;
+            }
+            std::size_t residentDistance = distanceFromHome(i, slot.key);
+            if (residentDistance < distance) {
+                std::swap(entry, slot);
+                distance = residentDistance;
+                displaced = true;
+            }
+        }
+    }
+
+    /**
+     * @brief Remove a key if it maps to the given pointer
+     *
+     * @return true if the key was removed
+     */
+    bool erase(std::uint64_t key, const T* expected) {
+        std::size_t i = locate(key);
+        if (i == kAbsent || slots_[i].value != expected) {
+            return false;
+        }
+
+        // Move the rest of the run one slot closer to home, up to the first entry that is already there
+        for (std::size_t j = (i + 1) & mask_; slots_[j].value && distanceFromHome(j, slots_[j].key) > 0;
+             j = (j + 1) & mask_) {
+            slots_[i] = slots_[j];
+            i = j;
+        }
+        slots_[i].value = nullptr;
+        size_--;
+        return true;
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Bytes held by the slot array
+     */
+    std::size_t memoryBytes() const { return slots_.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        std::uint64_t key = 0;
+        T* value = nullptr;
+    };
+
+    std::size_t home(std::uint64_t key) const {
+        return static_cast<std::size_t>(key) & mask_;
+    }
+
+    std::size_t distanceFromHome(std::size_t slot, std::uint64_t key) const {
+        return (slot - home(key)) & mask_;
+    }
+
+    static constexpr std::size_t kAbsent = ~std::size_t{0};
+
+    // Slot holding the key, or kAbsent
+    std::size_t locate(std::uint64_t key) const {
+        for (std::size_t i = home(key), distance = 0;; i = (i + 1) & mask_, ++distance) {
+            const Slot& slot = slots_[i];
+            if (!slot.value || distanceFromHome(i, slot.key) < distance) {
+                return kAbsent;
+            }
+            if (slot.key == key) {
+                return i;
+            }
+        }
+    }
+
+    void resize(std::size_t slots) {
+        std::pmr::vector<Slot> old(slots, slots_.get_allocator());
+        old.swap(slots_);
+        mask_ = slots - 1;
+        size_ = 0;
+        for (const Slot& slot : old) {
+            if (slot.value) {
+                insert(slot.key, slot.value);
+            }
+        }
+    }
+
+    std::pmr::vector<Slot> slots_;
+    std::size_t mask_ = 0;
+    std::size_t size_ = 0;
+};
+
+} // namespace util
+} // namespace engine
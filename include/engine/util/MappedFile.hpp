@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace engine {
+namespace util {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ * 
+ * RAII wrapper around mmap. The mapping is released when the object is destroyed.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Map a file into memory
+     * 
+     * @param path Path of the file to map
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat file: " + path);
+        }
+        
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map file: " + path);
+            }
+            data_ = static_cast<const std::uint8_t*>(addr);
+            
+            // The file is read front to back exactly once
+            ::madvise(addr, size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+#else
+        throw std::runtime_error("Memory-mapped files are not supported on this platform: " + path);
+#endif
+    }
+    
+    ~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (data_) {
+            ::munmap(const_cast<std::uint8_t*>(data_), size_);
+        }
+#endif
+    }
+    
+    // Delete copy and move constructors/operators
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+    
+    const std::uint8_t* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace util
+} // namespace engine
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <algorithm>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace engine {
+namespace util {
+
+/**
+ * @brief Memory resource that counts the bytes it hands out
+ * 
+ * Forwards every request to an upstream resource. Placed underneath an arena it
+ * shows how much memory the arena has actually reserved.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {}
+    
+    /**
+     * @brief Bytes currently allocated from the upstream resource
+     */
+    size_t bytesInUse() const { return bytesInUse_.load(std::memory_order_relaxed); }
+    
+    std::pmr::memory_resource* upstream() const { return upstream_; }
+
+private:
+    std::pmr::memory_resource* upstream_;
+    std::atomic<size_t> bytesInUse_{0};
+    
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = upstream_->allocate(bytes, alignment);
+        bytesInUse_.fetch_add(bytes, std::memory_order_relaxed);
+        return p;
+    }
+    
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        upstream_->deallocate(p, bytes, alignment);
+        bytesInUse_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/**
+ * @brief How large regions should be backed
+ */
+enum class HugePageMode {
+    NONE,         // Normal pages
+    TRANSPARENT,  // 2MB-aligned regions advised for transparent huge pages (MADV_HUGEPAGE)
+    EXPLICIT      // Pre-reserved hugetlbfs pages (MAP_HUGETLB), falling back to TRANSPARENT
+};
+
+/**
+ * @brief Memory resource that carves allocations out of large huge-page regions
+ * 
+ * Intended as the upstream of an Arena: it only sees the arena's chunk requests,
+ * bump-allocates them from 2MB-aligned regions and never returns memory before it
+ * is destroyed. Each region is first requested from hugetlbfs (EXPLICIT), then as
+ * transparent huge pages, then as normal pages, so a host without reserved huge
+ * pages still runs. Not synchronized; each owner gets its own instance.
+ */
+class HugePageResource : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+    
+    /**
+     * @brief Construct a huge-page resource
+     * 
+     * @param mode Preferred backing
+     * @param regionBytes Size of each mapped region (rounded up to whole huge pages)
+     */
+    explicit HugePageResource(HugePageMode mode, size_t regionBytes = 16 * kHugePageSize)
+        : mode_(mode), regionBytes_(roundUp(regionBytes, kHugePageSize)) {}
+    
+    ~HugePageResource() override {
+        for (const Region& region : regions_) {
+            unmap(region);
+        }
+    }
+    
+    HugePageResource(const HugePageResource&) = delete;
+    HugePageResource& operator=(const HugePageResource&) = delete;
+    
+    /**
+     * @brief Bytes mapped from pre-reserved hugetlbfs pages
+     */
+    size_t explicitHugePageBytes() const { return bytesByBacking_[static_cast<size_t>(Backing::HUGETLB)].load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Bytes mapped with a transparent huge page advice (the kernel may still use small pages)
+     */
+    size_t transparentHugePageBytes() const { return bytesByBacking_[static_cast<size_t>(Backing::THP)].load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Bytes mapped on normal pages
+     */
+    size_t normalPageBytes() const { return bytesByBacking_[static_cast<size_t>(Backing::NORMAL)].load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Make sure at least this many bytes are mapped, then touch every page of every region
+     * 
+     * Moves the page faults for the regions to the caller instead of the first
+     * allocations that land on them. Must not run concurrently with allocations.
+     * 
+     * @param bytes Minimum capacity to have mapped
+     */
+    void prefault(size_t bytes = 0) {
+        if (static_cast<size_t>(end_ - cursor_) < bytes) {
+            void* p = do_allocate(bytes, alignof(std::max_align_t));
+            cursor_ = static_cast<char*>(p);
+        }
+        for (const Region& region : regions_) {
+            volatile char* p = static_cast<char*>(region.base);
+            for (size_t offset = 0; offset < region.size; offset += 4096) {
+                p[offset] = p[offset];  // A write faults the page in; rewriting the value keeps live data intact
+            }
+        }
+    }
+
+private:
+    enum class Backing { HUGETLB, THP, NORMAL, COUNT };
+    
+    struct Region {
+        void* base;
+        size_t size;
+        Backing backing;
+    };
+    
+    HugePageMode mode_;
+    size_t regionBytes_;
+    std::vector<Region> regions_;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    std::atomic<size_t> bytesByBacking_[static_cast<size_t>(Backing::COUNT)] = {};
+    
+    static size_t roundUp(size_t value, size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+    
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        auto aligned = [alignment](char* p) {
+            auto address = reinterpret_cast<std::uintptr_t>(p);
+            return reinterpret_cast<char*>(roundUp(address, alignment));
+        };
+        
+        char* p = cursor_ ? aligned(cursor_) : nullptr;
+        if (!p || p + bytes > end_) {
+            Region region = map(roundUp(std::max(bytes + alignment, regionBytes_), kHugePageSize));
+            regions_.push_back(region);
+            bytesByBacking_[static_cast<size_t>(region.backing)].fetch_add(region.size, std::memory_order_relaxed);
+            cursor_ = static_cast<char*>(region.base);
+            end_ = cursor_ + region.size;
+            p = aligned(cursor_);
+        }
+        
+        cursor_ = p + bytes;
+        return p;
+    }
+    
+    void do_deallocate(void*, size_t, size_t) override {
+        // Regions are released together when the resource is destroyed
+    }
+    
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+    
+    Region map(size_t size) {
+#if defined(__linux__)
+        if (mode_ == HugePageMode::EXPLICIT) {
+            void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                return {p, size, Backing::HUGETLB};
+            }
+        }
+        
+        // Over-map by one huge page so the region can be trimmed to a 2MB boundary
+        size_t mapped = size + (mode_ == HugePageMode::NONE ? 0 : kHugePageSize);
+        void* raw = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        if (mode_ == HugePageMode::NONE) {
+            return {raw, size, Backing::NORMAL};
+        }
+        
+        char* start = static_cast<char*>(raw);
+        char* alignedStart = reinterpret_cast<char*>(roundUp(reinterpret_cast<std::uintptr_t>(start), kHugePageSize));
+        if (alignedStart > start) {
+            ::munmap(start, alignedStart - start);
+        }
+        char* alignedEnd = alignedStart + size;
+        if (start + mapped > alignedEnd) {
+            ::munmap(alignedEnd, start + mapped - alignedEnd);
+        }
+        
+        if (::madvise(alignedStart, size, MADV_HUGEPAGE) == 0) {
+            return {alignedStart, size, Backing::THP};
+        }
+        return {alignedStart, size, Backing::NORMAL};
+#else
+        return {::operator new(size, std::align_val_t(kHugePageSize)), size, Backing::NORMAL};
+#endif
+    }
+    
+    static void unmap(const Region& region) {
+#if defined(__linux__)
+        ::munmap(region.base, region.size);
+#else
+        ::operator delete(region.base, std::align_val_t(kHugePageSize));
+#endif
+    }
+};
+
+/**
+ * @brief Arena owned by a single order book or queue
+ * 
+ * A pool resource that recycles freed nodes by size class and takes its chunks
+ * from a counted upstream. It is unsynchronized: the owner must serialize all
+ * allocations, which the book and queue already do under their own locks.
+ * Destroying the arena returns every chunk to the upstream at once.
+ */
+class Arena {
+public:
+    explicit Arena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : counter_(upstream), pool_(poolOptions(), &counter_) {}
+    
+    // Containers hold a pointer to the arena, so it must stay in place
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(Arena&&) = delete;
+    
+    std::pmr::memory_resource* resource() { return &pool_; }
+    
+    /**
+     * @brief Bytes the arena has reserved from its upstream
+     */
+    size_t reservedBytes() const { return counter_.bytesInUse(); }
+
+private:
+    CountingResource counter_;
+    std::pmr::unsynchronized_pool_resource pool_;
+    
+    static std::pmr::pool_options poolOptions() {
+        std::pmr::pool_options options;
+        options.largest_required_pool_block = 1024;  // Tree nodes and deque buffers; larger blocks go straight upstream
+        options.max_blocks_per_chunk = 4096;
+        return options;
+    }
+};
+
+} // namespace util
+} // namespace engine
@@ -2,15 +2,31 @@
 
 #include <atomic>
 #include <cstdint>
+#include <fstream>
+#include <string>
 
 namespace engine {
 namespace util {
 
 /**
  * @brief Thread-safe order ID generator
+ * 
+ * Each thread reserves a block of IDs from the shared counter with one atomic
+ * add and then hands them out with a plain increment, so producer threads do
+ * not contend on the counter's cache line for every order. IDs are unique but
+ * only increasing per thread; IDs left in a thread's block when it exits are
+ * never reused.
+ * 
+ * The shared counter is the high-water mark: every ID ever handed out or
+ * reserved is below it. Persisting it and restoring it on restart keeps IDs
+ * unique across restarts.
+ * 
+ * Optionally the top bits of every ID carry a shard number for routing.
  */
 class OrderIdGenerator {
 public:
+    static constexpr std::uint64_t kDefaultBlockSize = 1024;
+    
     /**
      * @brief Get the singleton instance of the ID generator
      */
@@ -25,7 +41,106 @@ public:
      * @return uint64_t A globally unique order ID
      */
     std::uint64_t getNextId() {
-        return nextId_++;
+        Block& block = localBlock();
+        if (block.next == block.end) {
+            std::uint64_t size = blockSize_.load(std::memory_order_relaxed);
+            block.next = nextId_.fetch_add(size, std::memory_order_relaxed);
+            block.end = block.next + size;
+        }
+        return shardPrefix_.load(std::memory_order_relaxed) | block.next++;
+    }
+    
+    /**
+     * @brief Reserve a contiguous range of IDs
+     * 
+     * @param count Number of IDs to reserve
+     * @return uint64_t The first ID of the range; the range is [first, first + count)
+     */
+    std::uint64_t reserveRange(std::uint64_t count) {
+        return shardPrefix_.load(std::memory_order_relaxed) | nextId_.fetch_add(count, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Set the number of IDs a thread reserves at a time
+     * 
+     * Takes effect the next time a thread runs out of IDs.
+     * 
+     * @param blockSize IDs per block (at least 1)
+     */
+    void setBlockSize(std::uint64_t blockSize) {
+        blockSize_.store(blockSize > 0 ? blockSize : 1, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Encode a shard number in the top bits of every ID generated from now on
+     * 
+     * Call before any IDs are generated; the counter must stay below 2^(64 - shardBits).
+     * 
+     * @param shard Shard number
+     * @param shardBits Number of top bits used for the shard (0 disables sharding)
+     */
+    void setShard(std::uint64_t shard, unsigned shardBits) {
+        std::uint64_t prefix = shardBits == 0 || shardBits >= 64 ? 0 : shard << (64 - shardBits);
+        shardPrefix_.store(prefix, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Extract the shard number from an ID
+     * 
+     * @param id Order ID
+     * @param shardBits Number of top bits used for the shard
+     */
+    static std::uint64_t shardOf(std::uint64_t id, unsigned shardBits) {
+        return shardBits == 0 || shardBits >= 64 ? 0 : id >> (64 - shardBits);
+    }
+    
+    /**
+     * @brief Get the high-water mark: no ID handed out or reserved so far is at or above it
+     */
+    std::uint64_t getHighWaterMark() const {
+        return nextId_.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Restore a persisted high-water mark after a restart
+     * 
+     * The counter only moves forward, so restoring an older mark is harmless.
+     * 
+     * @param highWaterMark Value previously returned by getHighWaterMark()
+     */
+    void restore(std::uint64_t highWaterMark) {
+        std::uint64_t current = nextId_.load(std::memory_order_relaxed);
+        while (current < highWaterMark &&
+               !nextId_.compare_exchange_weak(current, highWaterMark, std::memory_order_relaxed)) {
+        }
+    }
+    
+    /**
+     * @brief Write the high-water mark to a file
+     * 
+     * @param path File to write
+     * @return true if the state was written
+     */
+    bool saveState(const std::string& path) const {
+        std::ofstream out(path, std::ios::trunc);
+        out << getHighWaterMark() << '\n';
+        return static_cast<bool>(out);
+    }
+    
+    /**
+     * @brief Restore the high-water mark from a file written by saveState
+     * 
+     * @param path File to read
+     * @return true if a state was read and restored
+     */
+    bool loadState(const std::string& path) {
+        std::ifstream in(path);
+        std::uint64_t highWaterMark = 0;
+        if (!(in >> highWaterMark)) {
+            return false;
+        }
+        restore(highWaterMark);
+        return true;
     }
     
     // Delete copy and move constructors/operators
@@ -37,7 +152,22 @@ public:
 private:
     OrderIdGenerator() : nextId_(1) {}  // Start IDs from 1
     
+    /**
+     * @brief Range of IDs reserved by the calling thread: [next, end)
+     */
+    struct Block {
+        std::uint64_t next = 0;
+        std::uint64_t end = 0;
+    };
+    
+    static Block& localBlock() {
+        thread_local Block block;
+        return block;
+    }
+    
     std::atomic<std::uint64_t> nextId_;
+    std::atomic<std::uint64_t> blockSize_{kDefaultBlockSize};
+    std::atomic<std::uint64_t> shardPrefix_{0};
 };
 
 } // namespace util
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <iostream>
+#include <iomanip>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace engine {
+namespace util {
+
+/**
+ * @brief Hardware events collected by PerfCounters
+ */
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    DTLB_MISSES,
+    COUNT
+};
+
+/**
+ * @brief Hardware performance counters around a code region
+ * 
+ * Opens one perf_event_open counter per event for the calling thread and any
+ * threads it creates afterwards. Events the kernel or hardware refuses (no PMU in
+ * a VM, perf_event_paranoid too strict, non-Linux platform) are reported as
+ * unavailable instead of failing the benchmark. Counts are scaled when the kernel
+ * had to multiplex counters.
+ */
+class PerfCounters {
+public:
+    static constexpr size_t kNumEvents = static_cast<size_t>(PerfEvent::COUNT);
+    
+    PerfCounters() {
+        fds_.fill(-1);
+        values_.fill(0);
+#if defined(__linux__)
+        for (size_t i = 0; i < kNumEvents; ++i) {
+            fds_[i] = openEvent(static_cast<PerfEvent>(i));
+        }
+#endif
+    }
+    
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+#endif
+    }
+    
+    // Delete copy and move constructors/operators
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    PerfCounters(PerfCounters&&) = delete;
+    PerfCounters& operator=(PerfCounters&&) = delete;
+    
+    /**
+     * @brief Reset and start all available counters
+     */
+    void start() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+    
+    /**
+     * @brief Stop all counters and latch their values
+     */
+    void stop() {
+#if defined(__linux__)
+        for (size_t i = 0; i < kNumEvents; ++i) {
+            if (fds_[i] < 0) {
+                continue;
+            }
+            ::ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+            
+            // value, time enabled, time running
+            std::uint64_t data[3] = {0, 0, 0};
+            if (::read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+                values_[i] = 0;
+                continue;
+            }
+            values_[i] = data[2] > 0 && data[2] < data[1]
+                ? static_cast<std::uint64_t>(static_cast<double>(data[0]) * data[1] / data[2])
+                : data[0];
+        }
+#endif
+    }
+    
+    /**
+     * @brief Check whether an event could be opened
+     */
+    bool available(PerfEvent event) const { return fds_[static_cast<size_t>(event)] >= 0; }
+    
+    /**
+     * @brief Check whether any event could be opened
+     */
+    bool anyAvailable() const {
+        for (int fd : fds_) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+    
+    /**
+     * @brief Get the latched count of an event
+     */
+    std::uint64_t value(PerfEvent event) const { return values_[static_cast<size_t>(event)]; }
+    
+    /**
+     * @brief Print the latched counts divided by the number of operations measured
+     * 
+     * @param operations Number of operations performed while the counters ran
+     */
+    void printPerOperation(std::uint64_t operations, std::ostream& os = std::cout) const {
+        if (!anyAvailable()) {
+            os << "  HW Counters:  unavailable (no PMU access; check perf_event_paranoid)" << std::endl;
+            return;
+        }
+        
+        const double ops = operations > 0 ? static_cast<double>(operations) : 1.0;
+        os << "  HW Counters per operation:" << std::endl;
+        for (size_t i = 0; i < kNumEvents; ++i) {
+            os << "    " << std::left << std::setw(14) << eventName(static_cast<PerfEvent>(i)) << std::right;
+            if (fds_[i] >= 0) {
+                os << std::fixed << std::setprecision(2) << values_[i] / ops << std::endl;
+            } else {
+                os << "n/a" << std::endl;
+            }
+        }
+        if (available(PerfEvent::CYCLES) && available(PerfEvent::INSTRUCTIONS) && value(PerfEvent::CYCLES) > 0) {
+            os << "    " << std::left << std::setw(14) << "IPC" << std::right << std::fixed << std::setprecision(2)
+               << static_cast<double>(value(PerfEvent::INSTRUCTIONS)) / value(PerfEvent::CYCLES) << std::endl;
+        }
+    }
+    
+    /**
+     * @brief Human readable event name
+     */
+    static const char* eventName(PerfEvent event) {
+        switch (event) {
+            case PerfEvent::CYCLES: return "cycles";
+            case PerfEvent::INSTRUCTIONS: return "instructions";
+            case PerfEvent::L1D_MISSES: return "L1d misses";
+            case PerfEvent::LLC_MISSES: return "LLC misses";
+            case PerfEvent::BRANCH_MISSES: return "branch misses";
+            case PerfEvent::DTLB_MISSES: return "dTLB misses";
+            case PerfEvent::COUNT: break;
+        }
+        return "unknown";
+    }
+
+private:
+    std::array<int, kNumEvents> fds_;
+    std::array<std::uint64_t, kNumEvents> values_;
+    
+#if defined(__linux__)
+    static int openEvent(PerfEvent event) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.inherit = 1;          // Include threads spawned while counting (engine workers)
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        
+        auto cacheConfig = [](std::uint64_t cache, std::uint64_t op, std::uint64_t result) {
+            return cache | (op << 8) | (result << 16);
+        };
+        
+        switch (event) {
+            case PerfEvent::CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PerfEvent::INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PerfEvent::L1D_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                          PERF_COUNT_HW_CACHE_RESULT_MISS);
+                break;
+            case PerfEvent::LLC_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case PerfEvent::BRANCH_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            case PerfEvent::DTLB_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                          PERF_COUNT_HW_CACHE_RESULT_MISS);
+                break;
+            case PerfEvent::COUNT:
+                return -1;
+        }
+        
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+};
+
+} // namespace util
+} // namespace engine
@@ -6,7 +6,9 @@
 #include <vector>
 #include <numeric>
 #include <algorithm>
+#include <memory>
 #include <iomanip>
+#include "engine/util/PerfCounters.hpp"
 
 namespace engine {
 namespace util {
@@ -67,11 +69,64 @@ private:
     TimePoint endTime_;
 };
 
+/**
+ * @brief Summary statistics over a set of latency samples
+ */
+struct LatencySummary {
+    size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+    
+    /**
+     * @brief Summarize a set of samples
+     * 
+     * @param samples Samples in any unit; sorted in place
+     * @return LatencySummary Statistics in the same unit as the samples
+     */
+    static LatencySummary fromSamples(std::vector<double>& samples) {
+        LatencySummary summary;
+        if (samples.empty()) {
+            return summary;
+        }
+        
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&samples](double p) {
+            size_t idx = static_cast<size_t>(p * (samples.size() - 1));
+            return samples[idx];
+        };
+        
+        summary.count = samples.size();
+        summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        summary.p50 = percentile(0.50);
+        summary.p90 = percentile(0.90);
+        summary.p99 = percentile(0.99);
+        summary.p999 = percentile(0.999);
+        summary.max = samples.back();
+        return summary;
+    }
+};
+
 /**
  * @brief Performance benchmark runner
  */
 class PerformanceBenchmark {
 public:
+    /**
+     * @brief Enable hardware performance counters around every benchmark
+     * 
+     * @param enabled Whether counters should be collected
+     */
+    static void enableHardwareCounters(bool enabled) { hardwareCounters_ = enabled; }
+    
+    /**
+     * @brief Check whether hardware performance counters are collected
+     */
+    static bool hardwareCountersEnabled() { return hardwareCounters_; }
+    
     /**
      * @brief Run a benchmark function multiple times and report statistics
      * 
@@ -79,9 +134,11 @@ public:
      * @param func Function to benchmark
      * @param iterations Number of iterations to run
      * @param warmupIterations Number of warmup iterations (not counted in stats)
+     * @param opsPerIteration Operations performed per call of func, used to report counters per operation
      */
     template<typename Func>
-    static void runBenchmark(const std::string& name, Func func, int iterations, int warmupIterations = 3) {
+    static void runBenchmark(const std::string& name, Func func, int iterations, int warmupIterations = 3,
+                             int opsPerIteration = 1) {
         std::cout << "Running benchmark: " << name << std::endl;
         
         // Warmup
@@ -93,6 +150,13 @@ public:
         std::vector<double> measurements;
         measurements.reserve(iterations);
         
+        // Only opened when requested; opening counters costs a few syscalls
+        std::unique_ptr<PerfCounters> counters;
+        if (hardwareCounters_) {
+            counters = std::make_unique<PerfCounters>();
+            counters->start();
+        }
+        
         for (int i = 0; i < iterations; ++i) {
             PerformanceTimer timer;
             timer.start();
@@ -103,6 +167,10 @@ public:
             measurements.push_back(timer.elapsedMicroseconds());
         }
         
+        if (counters) {
+            counters->stop();
+        }
+        
         // Calculate statistics
         double sum = std::accumulate(measurements.begin(), measurements.end(), 0.0);
         double mean = sum / iterations;
@@ -130,9 +198,16 @@ public:
                   << "  P99:          " << p99 << " μs" << std::endl
                   << "  Min:          " << min << " μs" << std::endl
                   << "  Max:          " << max << " μs" << std::endl
-                  << "  Throughput:   " << std::setprecision(0) << throughput << " ops/sec" << std::endl
-                  << std::endl;
+                  << "  Throughput:   " << std::setprecision(0) << throughput << " ops/sec" << std::endl;
+        
+        if (counters) {
+            counters->printPerOperation(static_cast<std::uint64_t>(iterations) * opsPerIteration);
+        }
+        std::cout << std::endl;
     }
+
+private:
+    static inline bool hardwareCounters_ = false;
 };
 
 } // namespace util
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace engine {
+namespace util {
+
+/**
+ * @brief Get the resident set size of the current process
+ * 
+ * @return size_t Resident bytes, or 0 if the platform does not expose it
+ */
+inline size_t currentRssBytes() {
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Get the anonymous memory of the current process backed by transparent huge pages
+ * 
+ * @return size_t Bytes on transparent huge pages, or 0 if the platform does not expose it
+ */
+inline size_t currentAnonHugePageBytes() {
+#if defined(__linux__)
+    std::ifstream rollup("/proc/self/smaps_rollup");
+    std::string key;
+    size_t kb = 0;
+    while (rollup >> key) {
+        if (key == "AnonHugePages:" && rollup >> kb) {
+            return kb * 1024;
+        }
+    }
+#endif
+    return 0;
+}
+
+} // namespace util
+} // namespace engine
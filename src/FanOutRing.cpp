@@ -0,0 +1,174 @@
+#include "engine/FanOutRing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+namespace engine {
+
+namespace {
+
+std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Lag is sampled once per this many delivered events
+constexpr std::uint64_t kLagSampleInterval = 64;
+
+// Empty polls a subscriber spins through before it starts sleeping
+constexpr int kIdleSpins = 64;
+
+} // namespace
+
+FanOutRing::FanOutRing(std::size_t capacity)
+    : slots_(roundUpToPowerOfTwo(std::max<std::size_t>(capacity, 2))),
+      mask_(slots_.size() - 1) {
+}
+
+FanOutRing::~FanOutRing() {
+    stop();
+}
+
+void FanOutRing::addSubscriber(const std::string& name, LagPolicy policy, Handler handler) {
+    if (running_) {
+        throw std::logic_error("Fan-out subscribers must be added before the ring is started");
+    }
+    auto subscriber = std::make_unique<Subscriber>();
+    subscriber->name = name;
+    subscriber->policy = policy;
+    subscriber->handler = std::move(handler);
+    subscriber->cursor.store(claimed_.load());
+    subscribers_.push_back(std::move(subscriber));
+
+    // Recompute the gating limit on the next publish
+    gatingLimit_.store(0);
+}
+
+void FanOutRing::start() {
+    if (running_) return;
+    running_ = true;
+    stopping_ = false;
+    for (auto& subscriber : subscribers_) {
+        if (!subscriber->disconnected) {
+            subscriber->thread = std::thread(&FanOutRing::runSubscriber, this, std::ref(*subscriber));
+        }
+    }
+}
+
+void FanOutRing::stop() {
+    if (!running_) return;
+    stopping_ = true;
+    for (auto& subscriber : subscribers_) {
+        if (subscriber->thread.joinable()) {
+            subscriber->thread.join();
+        }
+    }
+    running_ = false;
+}
+
+std::vector<FanOutSubscriberStats> FanOutRing::getStats() const {
+    std::uint64_t published = claimed_.load();
+    std::vector<FanOutSubscriberStats> stats;
+    for (const auto& subscriber : subscribers_) {
+        std::uint64_t cursor = subscriber->cursor.load();
+        std::uint64_t skipped = subscriber->skipped.load();
+        std::uint64_t lag = published > cursor ? published - cursor : 0;
+        stats.push_back(FanOutSubscriberStats{
+            subscriber->name,
+            subscriber->policy,
+            subscriber->delivered.load(),
+            skipped,
+            lag,
+            std::max(subscriber->maxLag.load(), lag),
+            subscriber->disconnected.load()
+        });
+    }
+    return stats;
+}
+
+void FanOutRing::waitForGatingSubscribers(std::uint64_t sequence) {
+    while (true) {
+        std::uint64_t limit = std::numeric_limits<std::uint64_t>::max();
+        for (const auto& subscriber : subscribers_) {
+            if (subscriber->policy == LagPolicy::BLOCK && !subscriber->disconnected.load(std::memory_order_relaxed)) {
+                limit = std::min(limit, subscriber->cursor.load(std::memory_order_acquire) + slots_.size());
+            }
+        }
+        gatingLimit_.store(limit, std::memory_order_release);
+        if (sequence < limit) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void FanOutRing::recordLag(Subscriber& subscriber, std::uint64_t cursor) {
+    std::uint64_t lag = claimed_.load(std::memory_order_relaxed) - cursor;
+    if (lag > subscriber.maxLag.load(std::memory_order_relaxed)) {
+        subscriber.maxLag.store(lag, std::memory_order_relaxed);
+    }
+}
+
+void FanOutRing::runSubscriber(Subscriber& subscriber) {
+    std::uint64_t cursor = subscriber.cursor.load(std::memory_order_relaxed);
+    int idle = 0;
+
+    while (true) {
+        const Slot& slot = slots_[cursor & mask_];
+        std::uint64_t published = slot.sequence.load(std::memory_order_acquire);
+
+        bool lapped = false;
+        if (published == cursor + 1) {
+            // Seqlock read: the copy is only valid if the slot did not change meanwhile
+            EngineEvent event = slot.event;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == published) {
+                subscriber.handler(event);
+                ++cursor;
+                subscriber.cursor.store(cursor, std::memory_order_release);
+                subscriber.delivered.store(subscriber.delivered.load(std::memory_order_relaxed) + 1,
+                                           std::memory_order_relaxed);
+                idle = 0;
+
+                if ((cursor & (kLagSampleInterval - 1)) == 0) {
+                    recordLag(subscriber, cursor);
+                }
+                continue;
+            }
+            // Only a publisher a full lap ahead rewrites a published slot
+            lapped = true;
+        } else if (published != kWriting && published > cursor + 1) {
+            lapped = true;
+        }
+
+        if (lapped) {
+            recordLag(subscriber, cursor);
+            if (subscriber.policy == LagPolicy::DISCONNECT) {
+                subscriber.disconnected.store(true);
+                return;
+            }
+            // CONFLATE: continue half a ring behind the newest event
+            std::uint64_t resume = claimed_.load(std::memory_order_relaxed) - slots_.size() / 2;
+            subscriber.skipped.fetch_add(resume - cursor, std::memory_order_relaxed);
+            cursor = resume;
+            subscriber.cursor.store(cursor, std::memory_order_release);
+            continue;
+        }
+
+        // Nothing new: leave once everything published before stop() has been delivered
+        if (stopping_.load(std::memory_order_acquire) && cursor >= claimed_.load(std::memory_order_acquire)) {
+            return;
+        }
+        if (++idle < kIdleSpins) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+} // namespace engine
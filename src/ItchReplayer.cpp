@@ -0,0 +1,175 @@
+#include "engine/replay/ItchReplayer.hpp"
+#include "engine/util/PerformanceTimer.hpp"
+#include <chrono>
+#include <thread>
+#include <unordered_set>
+
+namespace engine {
+namespace replay {
+
+namespace {
+
+// Cancels and deletes pull liquidity and take the priority lane; replaces add an order and do not
+bool isCancel(const ItchMessage& msg) {
+    return msg.type == ItchMessageType::ORDER_CANCEL || msg.type == ItchMessageType::ORDER_DELETE;
+}
+
+} // namespace
+
+ItchReplayStats ItchReplayer::replay(ItchReader& reader) {
+    using Clock = std::chrono::steady_clock;
+    
+    ItchReplayStats stats;
+    ItchMessage msg{};
+    LaneSequencer<ItchMessage> burst(options_.cancelPriorityRun);
+    std::unordered_set<std::uint64_t> waitingRefs;  // Orders named by the burst's normal lane
+    bool first = true;
+    std::uint64_t firstTimestamp = 0;
+    std::uint64_t burstTimestamp = 0;
+    Clock::time_point wallStart;
+    
+    util::PerformanceTimer timer;
+    timer.start();
+    
+    while (reader.next(msg)) {
+        if (options_.stockLocate != 0 && msg.stockLocate != options_.stockLocate) {
+            continue;
+        }
+        
+        // A new timestamp closes the burst of messages that arrived together
+        if (!burst.empty() && msg.timestamp != burstTimestamp) {
+            applyBurst(burst, stats);
+            waitingRefs.clear();
+        }
+        if (!burst.empty()) {
+            push(burst, waitingRefs, msg);
+            continue;
+        }
+        burstTimestamp = msg.timestamp;
+        
+        if (options_.pace == ReplayPace::RECORDED) {
+            if (first) {
+                firstTimestamp = msg.timestamp;
+                wallStart = Clock::now();
+                first = false;
+            }
+            
+            // Sleep for most of the gap and spin for the rest to keep the schedule tight
+            auto offset = std::chrono::nanoseconds(
+                static_cast<std::int64_t>((msg.timestamp - firstTimestamp) / options_.speed));
+            auto due = wallStart + offset;
+            auto now = Clock::now();
+            if (due - now > std::chrono::microseconds(200)) {
+                std::this_thread::sleep_until(due - std::chrono::microseconds(100));
+            }
+            while (Clock::now() < due) {
+            }
+        }
+        
+        push(burst, waitingRefs, msg);
+    }
+    applyBurst(burst, stats);
+    
+    timer.stop();
+    stats.elapsedNanoseconds = timer.elapsedNanoseconds();
+    return stats;
+}
+
+void ItchReplayer::push(LaneSequencer<ItchMessage>& burst, std::unordered_set<std::uint64_t>& waitingRefs,
+                        const ItchMessage& msg) {
+    if (burst.getMaxPriorityRun() == 0) {
+        burst.push(msg, false);
+        return;
+    }
+    
+    // A cancel never overtakes a waiting message for the same order, such as the add that created it
+    bool priority = isCancel(msg) && waitingRefs.count(msg.orderRef) == 0;
+    if (!priority) {
+        waitingRefs.insert(msg.orderRef);
+        if (msg.type == ItchMessageType::ORDER_REPLACE) {
+            waitingRefs.insert(msg.newOrderRef);
+        }
+    }
+    burst.push(msg, priority);
+}
+
+void ItchReplayer::applyBurst(LaneSequencer<ItchMessage>& burst, ItchReplayStats& stats) {
+    while (!burst.empty()) {
+        apply(burst.pop(), stats);
+        stats.messages++;
+    }
+}
+
+bool ItchReplayer::route(const ItchMessage& msg, Order::InstrumentId& instrument) const {
+    if (options_.stockLocate != 0) {
+        instrument = 0;
+        return true;
+    }
+    if (msg.stockLocate == 0 || msg.stockLocate > engine_.getNumBooks()) {
+        return false;
+    }
+    instrument = static_cast<Order::InstrumentId>(msg.stockLocate - 1);
+    return true;
+}
+
+void ItchReplayer::apply(const ItchMessage& msg, ItchReplayStats& stats) {
+    Order::InstrumentId instrument;
+    if (!route(msg, instrument)) {
+        stats.unroutedMessages++;
+        return;
+    }
+    
+    switch (msg.type) {
+        case ItchMessageType::ADD_ORDER:
+        case ItchMessageType::ADD_ORDER_MPID: {
+            auto order = std::make_shared<Order>(
+                msg.orderRef, msg.side, OrderType::LIMIT, msg.enginePrice(), msg.shares, instrument);
+            stats.trades += engine_.processOrderSync(order).size();
+            stats.adds++;
+            break;
+        }
+        
+        case ItchMessageType::ORDER_EXECUTED:
+        case ItchMessageType::ORDER_EXECUTED_PRICE:
+            // The feed names the executed order; an aggressor replayed against the book could hit another one
+            if (engine_.reduceOrderSync(msg.orderRef, msg.shares, instrument)) {
+                stats.trades++;
+                stats.executions++;
+            } else {
+                stats.unknownOrders++;
+            }
+            break;
+        
+        case ItchMessageType::ORDER_CANCEL:
+            if (engine_.reduceOrderSync(msg.orderRef, msg.shares, instrument)) {
+                stats.cancels++;
+            } else {
+                stats.unknownOrders++;
+            }
+            break;
+        
+        case ItchMessageType::ORDER_DELETE:
+            if (engine_.cancelOrderSync(msg.orderRef, instrument)) {
+                stats.deletes++;
+            } else {
+                stats.unknownOrders++;
+            }
+            break;
+        
+        case ItchMessageType::ORDER_REPLACE: {
+            auto original = engine_.getOrderBook(instrument).findOrder(msg.orderRef);
+            if (!original || !engine_.cancelOrderSync(msg.orderRef, instrument)) {
+                stats.unknownOrders++;
+                break;
+            }
+            auto order = std::make_shared<Order>(
+                msg.newOrderRef, original->getSide(), OrderType::LIMIT, msg.enginePrice(), msg.shares, instrument);
+            stats.trades += engine_.processOrderSync(order).size();
+            stats.replaces++;
+            break;
+        }
+    }
+}
+
+} // namespace replay
+} // namespace engine
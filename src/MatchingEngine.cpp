@@ -1,12 +1,203 @@
 #include "engine/MatchingEngine.hpp"
-#include <iostream>
+#include "engine/util/AsyncLogger.hpp"
 #include <chrono>
 #include <functional>
+#include <stdexcept>
+#include <random>
+#include <cmath>
 
 namespace engine {
 
+namespace {
+
+Order::Quantity quantityTraded(const std::vector<Trade>& trades) {
+    Order::Quantity quantity = 0;
+    for (const Trade& trade : trades) {
+        quantity += trade.getQuantity();
+    }
+    return quantity;
+}
+
+Order::Quantity quantityTraded(const std::vector<Fill>& fills) {
+    Order::Quantity quantity = 0;
+    for (const Fill& fill : fills) {
+        quantity += fill.trade.getQuantity();
+    }
+    return quantity;
+}
+
+} // namespace
+
+/**
+ * @brief Stage work of the order pipeline
+ */
+struct MatchingEngine::PipelineStages {
+    MatchingEngine* engine;
+    
+    bool checkRisk(Order& order) {
+        // Admission validated the order and left the pre-trade checks to this stage
+        if (engine->risk_ && engine->risk_->check(order) != RiskRejectReason::NONE) {
+            order.reject();
+            return false;
+        }
+        return true;
+    }
+    
+    void journal(const OrderRequest& request) {
+        // A failed journal stops and counts what it loses rather than stopping the engine
+        if (engine->journal_) {
+            engine->journal_->append(request);
+        }
+    }
+    
+    void endJournalBatch() {
+        if (engine->journal_) {
+            engine->journal_->flush();
+        }
+    }
+    
+    void match(const std::shared_ptr<Order>& order, std::vector<Fill>& fills) {
+        auto collect = [&fills](const Fill& fill) {
+            fills.push_back(fill);
+        };
+        OrderBook& book = engine->bookFor(order->getInstrument());
+        
+        // An elapsed interruption is uncrossed first, unless the instrument is halted; its fills are published with the order's
+        if (book.isAuctionDue() && !engine->halts_.isInstrumentHalted(order->getInstrument())) {
+            engine->uncrossBook(book, collect);
+        }
+        
+        // Halts are checked in the book, so they also stop orders already in the ring
+        auto trades = book.addOrder(order, engine->haltCheck(), collect);
+        if (order->getStatus() == OrderStatus::REJECTED) {
+            engine->releaseHalted(*order);
+            return;
+        }
+        if (engine->risk_) {
+            engine->risk_->onOrderMatched(*order, quantityTraded(trades));
+        }
+    }
+    
+    std::shared_ptr<Order> cancel(const OrderRequest& request) {
+        return engine->applyCancel(request);
+    }
+    
+    void publish(const Order& order, const std::vector<Fill>& fills, bool rejected) {
+        for (const Fill& fill : fills) {
+            engine->dispatcher_.onFill(fill);
+        }
+        if (!rejected && order.getStatus() != OrderStatus::REJECTED) {
+            engine->recordProcessed(fills.size(), quantityTraded(fills));
+        }
+        engine->dispatcher_.onOrderProcessed(order);
+        engine->completeOrder();
+    }
+    
+    void publishCancel(const Order* order) {
+        engine->reportCancel(order);
+        engine->completeOrder();
+    }
+};
+
+namespace {
+
+std::vector<std::unique_ptr<util::HugePageResource>> makePageResources(const MatchingEngineConfig& config) {
+    std::vector<std::unique_ptr<util::HugePageResource>> resources;
+    if (config.useArenas && config.hugePages != util::HugePageMode::NONE) {
+        for (size_t i = 0; i < config.numBooks + 1; ++i) {
+            resources.push_back(std::make_unique<util::HugePageResource>(config.hugePages));
+        }
+    }
+    return resources;
+}
+
+std::vector<InstrumentSpec> instrumentSpecs(const MatchingEngineConfig& config) {
+    if (config.instruments.size() > config.numBooks) {
+        throw std::invalid_argument("Reference data given for more instruments than there are books");
+    }
+    std::vector<InstrumentSpec> specs = config.instruments;
+    specs.resize(config.numBooks);
+    return specs;
+}
+
+MatchingEngineConfig workerConfig(size_t numWorkers) {
+    MatchingEngineConfig config;
+    config.numWorkers = numWorkers;
+    return config;
+}
+
+} // namespace
+
 MatchingEngine::MatchingEngine(size_t numWorkers)
-    : numWorkers_(numWorkers) {
+    : MatchingEngine(workerConfig(numWorkers)) {
+}
+
+MatchingEngine::MatchingEngine(const MatchingEngineConfig& config)
+    : pageResources_(makePageResources(config)),
+      orderQueue_(config.useArenas,
+                  pageResources_.empty()
+                      ? std::pmr::new_delete_resource()
+                      : static_cast<std::pmr::memory_resource*>(pageResources_.back().get()),
+                  config.cancelPriorityRun),
+      numWorkers_(config.numWorkers),
+      warmUp_(config.warmUp),
+      warmUpOrders_(config.warmUpOrders),
+      circuitBreakers_(config.circuitBreakers),
+      fanOutCapacity_(config.fanOutCapacity),
+      validator_(instrumentSpecs(config)),
+      halts_(config.numBooks, config.numAccounts) {
+    if (config.numBooks == 0) {
+        throw std::invalid_argument("Matching engine needs at least one order book");
+    }
+    if (config.numBooks > 65536) {
+        throw std::invalid_argument("Trades carry a 16-bit instrument ID; at most 65536 books are supported");
+    }
+    
+    dispatcher_.get<TradeLogSubscriber>().enabled = config.logTrades;
+    
+    if (config.riskChecks) {
+        risk_ = std::make_unique<RiskEngine>(config.numAccounts, config.numBooks, config.riskLimits);
+        dispatcher_.get<RiskSubscriber>().risk = risk_.get();
+    }
+    
+    // Positions must see every fill, so the subscriber holds the engine back rather than skip
+    if (config.trackPositions) {
+        positions_ = std::make_unique<PositionKeeper>(config.numAccounts, config.numBooks);
+        addEventSubscriber("positions", LagPolicy::BLOCK, [keeper = positions_.get()](const EngineEvent& event) {
+            if (event.type == EngineEventType::TRADE) {
+                keeper->onFill(event.fill);
+            }
+        });
+    }
+    
+    // The trade store is written on its own subscriber thread and must not miss fills either.
+    // A write error disables the store, which then only counts the fills it loses, so the
+    // subscriber keeps up and the engine is never held back or torn down by the disk
+    if (!config.tradeStorePath.empty()) {
+        tradeStore_ = std::make_unique<TradeStoreWriter>(config.tradeStorePath);
+        addEventSubscriber("trade-store", LagPolicy::BLOCK, [store = tradeStore_.get()](const EngineEvent& event) {
+            if (event.type == EngineEventType::TRADE) {
+                store->append(event.fill);
+            }
+        });
+    }
+    
+    if (config.pipeline) {
+        if (!config.journalPath.empty()) {
+            journal_ = std::make_unique<OrderJournal>(config.journalPath);
+        }
+        pipeline_ = std::make_unique<OrderPipeline<PipelineStages>>(
+            PipelineStages{this}, config.pipelineCapacity, config.pinPipelineStages);
+    }
+    
+    orderBooks_.reserve(config.numBooks);
+    for (size_t i = 0; i < config.numBooks; ++i) {
+        std::pmr::memory_resource* upstream = pageResources_.empty()
+            ? std::pmr::new_delete_resource()
+            : pageResources_[i].get();
+        orderBooks_.push_back(std::make_unique<OrderBook>(config.useArenas, upstream));
+        orderBooks_.back()->setTickTable(validator_.getTickTable(static_cast<Order::InstrumentId>(i)));
+    }
 }
 
 MatchingEngine::~MatchingEngine() {
@@ -18,14 +209,87 @@ MatchingEngine::~MatchingEngine() {
 void MatchingEngine::start() {
     if (running_) return;
     
+    if (warmUp_) {
+        runWarmUp();
+    }
+    
+    // Bands go on after the warm-up flow, whose prices must not become references
+    for (auto& book : orderBooks_) {
+        book->setCircuitBreaker(circuitBreakers_);
+    }
+    
     running_ = true;
     
+    if (fanOut_) {
+        fanOut_->start();
+        dispatcher_.get<FanOutPublisher>().ring = fanOut_.get();
+    }
+    
+    if (pipeline_) {
+        pipeline_->start();
+        util::AsyncLogger::getInstance().log("Matching engine started with a risk/journal/match/publish pipeline.");
+        return;
+    }
+    
     // Create worker threads
     for (size_t i = 0; i < numWorkers_; ++i) {
         workerThreads_.emplace_back(&MatchingEngine::workerFunction, this);
     }
     
-    std::cout << "Matching engine started with " << numWorkers_ << " worker threads." << std::endl;
+    util::AsyncLogger::getInstance().log("Matching engine started with {} worker threads.", numWorkers_);
+}
+
+void MatchingEngine::runWarmUp() {
+    // Synthetic orders use IDs far above anything the ID generator hands out
+    constexpr Order::OrderId kWarmUpIdBase = Order::OrderId{1} << 62;
+    
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<> priceDist(90.0, 110.0);
+    std::uniform_int_distribution<Order::Quantity> qtyDist(1, 100);
+    std::bernoulli_distribution coin(0.5);
+    std::bernoulli_distribution marketDist(0.2);
+    
+    // The flow runs through each real book rather than a separate one so that
+    // the book's own arena is faulted in with the exact node sizes it uses
+    Order::OrderId nextId = kWarmUpIdBase;
+    for (size_t instrument = 0; instrument < orderBooks_.size(); ++instrument) {
+        OrderBook& book = *orderBooks_[instrument];
+        auto id = static_cast<Order::InstrumentId>(instrument);
+        
+        // Build a book of the configured depth: bids below 100.00, asks from 100.00 up
+        Order::OrderId firstRestingId = nextId;
+        for (size_t i = 0; i < warmUpOrders_; ++i) {
+            bool buy = i % 2 == 0;
+            double offset = static_cast<double>((i / 2) % 1000);
+            double price = buy ? (9999.0 - offset) / 100.0 : (10000.0 + offset) / 100.0;
+            book.addOrder(std::make_shared<Order>(nextId++, buy ? OrderSide::BUY : OrderSide::SELL,
+                                                  OrderType::LIMIT, price, 100, id));
+        }
+        
+        // Crossing limit and market orders exercise the match loops
+        for (size_t i = 0; i < warmUpOrders_ / 2; ++i) {
+            bool market = marketDist(gen);
+            double price = std::round(priceDist(gen) * 100) / 100;
+            book.addOrder(std::make_shared<Order>(nextId++, coin(gen) ? OrderSide::BUY : OrderSide::SELL,
+                                                  market ? OrderType::MARKET : OrderType::LIMIT,
+                                                  market ? 0.0 : price, qtyDist(gen), id));
+        }
+        
+        // Cancels and lookups for the rest of the book API
+        for (Order::OrderId restingId = firstRestingId; restingId < firstRestingId + warmUpOrders_; restingId += 4) {
+            book.findOrder(restingId);
+            book.cancelOrder(restingId);
+        }
+        
+        book.reset();
+    }
+    
+    orderQueue_.prefault(warmUpOrders_);
+    
+    // Touch whatever the flow did not reach in the huge-page regions
+    for (auto& resource : pageResources_) {
+        resource->prefault();
+    }
 }
 
 void MatchingEngine::stop() {
@@ -33,6 +297,11 @@ void MatchingEngine::stop() {
     
     running_ = false;
     
+    // Let the pipeline finish what was submitted
+    if (pipeline_) {
+        pipeline_->stop();
+    }
+    
     // Signal all workers to stop
     orderQueue_.shutdown();
     
@@ -44,57 +313,371 @@ void MatchingEngine::stop() {
     }
     
     workerThreads_.clear();
-    std::cout << "Matching engine stopped." << std::endl;
+    
+    // Deliver the remaining events to the fan-out subscribers
+    if (fanOut_) {
+        dispatcher_.get<FanOutPublisher>().ring = nullptr;
+        fanOut_->stop();
+    }
+    if (tradeStore_) {
+        tradeStore_->flush();
+    }
+    
+    // Write out everything the engine logged before returning to the caller
+    util::AsyncLogger& logger = util::AsyncLogger::getInstance();
+    logger.log("Matching engine stopped.");
+    logger.flush();
 }
 
-void MatchingEngine::submitOrder(std::shared_ptr<Order> order) {
+bool MatchingEngine::submitOrder(std::shared_ptr<Order> order) {
     if (!running_) {
         throw std::runtime_error("Matching engine is not running");
     }
     
-    orderQueue_.enqueue(order);
+    // Reject unroutable orders here rather than on a worker thread
+    bookFor(order->getInstrument());
+    
+    // Validation and pre-trade risk run on the gateway thread, so rejects never reach the queue
+    if (!admitOrder(*order, !pipeline_)) {
+        return false;
+    }
+    
+    ordersSubmitted_++;
+    if (pipeline_) {
+        pipeline_->submit(std::move(order));
+    } else {
+        orderQueue_.enqueue(order);
+    }
+    return true;
+}
+
+std::size_t MatchingEngine::submitOrders(const std::shared_ptr<Order>* orders, std::size_t count) {
+    if (!running_) {
+        throw std::runtime_error("Matching engine is not running");
+    }
+    
+    // Check every route before admitting anything, so an unroutable order leaves no risk reserved
+    for (std::size_t i = 0; i < count; ++i) {
+        bookFor(orders[i]->getInstrument());
+    }
+    
+    std::vector<std::shared_ptr<Order>> admitted;
+    admitted.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (admitOrder(*orders[i], !pipeline_)) {
+            admitted.push_back(orders[i]);
+        }
+    }
+    
+    ordersSubmitted_ += admitted.size();
+    if (pipeline_) {
+        pipeline_->submit(admitted.data(), admitted.size());
+    } else {
+        orderQueue_.enqueue(admitted.data(), admitted.size());
+    }
+    return admitted.size();
+}
+
+void MatchingEngine::submitCancel(Order::OrderId orderId, Order::InstrumentId instrument) {
+    submitCancelRequest(OrderRequest::cancel(orderId, instrument));
+}
+
+void MatchingEngine::submitReduce(Order::OrderId orderId, Order::Quantity quantity, Order::InstrumentId instrument) {
+    submitCancelRequest(OrderRequest::reduce(orderId, quantity, instrument));
+}
+
+void MatchingEngine::submitCancelRequest(const OrderRequest& request) {
+    if (!running_) {
+        throw std::runtime_error("Matching engine is not running");
+    }
+    bookFor(request.instrument);
+    
+    // The ring keeps arrival order, so the match stage sees the order before its cancel
+    ordersSubmitted_++;
+    if (pipeline_) {
+        pipeline_->submit(request);
+        return;
+    }
+    EnqueueResult result = orderQueue_.enqueue(request);
+    if (result.action == EnqueueAction::QUEUED) {
+        return;
+    }
+    
+    // Coalesced in the queue: the request is done, and an annulled order will never be dequeued
+    if (result.order && risk_) {
+        risk_->onOrderRemoved(*result.order, result.removedQuantity);
+    }
+    stats_.totalCancelsProcessed++;
+    stats_.totalCancelsCoalesced++;
+    if (result.action == EnqueueAction::ANNULLED) {
+        dispatcher_.onOrderProcessed(*result.order);
+        completeOrder();
+    }
+    completeOrder();
+}
+
+void MatchingEngine::waitForCompletion() {
+    uint64_t target = ordersSubmitted_.load();
+    
+    completionWaiters_++;
+    {
+        std::unique_lock<std::mutex> lock(completionMutex_);
+        completionCv_.wait(lock, [this, target] { return ordersCompleted_.load() >= target; });
+    }
+    completionWaiters_--;
 }
 
 std::vector<Trade> MatchingEngine::processOrderSync(std::shared_ptr<Order> order) {
-    // Process the order in our single order book
-    // In the future, this would select the appropriate order book based on instrument
-    auto trades = orderBook_.addOrder(order, [this](const Trade& trade) {
-        this->onTrade(trade);
+    // Check the route before reserving risk for the order
+    bookFor(order->getInstrument());
+    
+    if (!admitOrder(*order)) {
+        return {};
+    }
+    return executeOrder(order);
+}
+
+bool MatchingEngine::admitOrder(Order& order, bool checkRisk) {
+    // Static checks first, so risk never reserves for an order the book would not take
+    if (halts_.blocks(order) ||
+        validator_.validate(order) != ValidationRejectReason::NONE ||
+        (checkRisk && risk_ && risk_->check(order) != RiskRejectReason::NONE)) {
+        order.reject();
+        return false;
+    }
+    return true;
+}
+
+void MatchingEngine::releaseHalted(const Order& order) {
+    if (risk_) {
+        risk_->onOrderRemoved(order, order.getRemainingQuantity());
+    }
+}
+
+std::vector<Trade> MatchingEngine::executeOrder(const std::shared_ptr<Order>& order) {
+    // Route the order to the book for its instrument
+    OrderBook& book = bookFor(order->getInstrument());
+    if (book.isAuctionDue()) {
+        resumeTrading(order->getInstrument());
+    }
+    
+    // A halt set after the order was admitted still stops it, under the same lock as a kill switch's sweep
+    auto trades = book.addOrder(order, haltCheck(), [this](const Fill& fill) {
+        dispatcher_.onFill(fill);
     });
+    if (order->getStatus() == OrderStatus::REJECTED) {
+        releaseHalted(*order);
+        return {};
+    }
     
-    // Update statistics
-    stats_.totalOrdersProcessed++;
+    Order::Quantity quantity = quantityTraded(trades);
+    if (risk_) {
+        risk_->onOrderMatched(*order, quantity);
+    }
+    recordProcessed(trades.size(), quantity);
+    return trades;
+}
+
+template<typename FillSink>
+std::vector<Trade> MatchingEngine::uncrossBook(OrderBook& book, FillSink&& onFill) {
+    return book.uncross([this, &onFill](const Fill& fill, const Order& buyOrder, const Order& sellOrder) {
+        // Both orders rested and reserved at their own limits, whatever the auction price
+        if (risk_) {
+            risk_->onOrderMatched(buyOrder, fill.trade.getQuantity());
+            risk_->onOrderMatched(sellOrder, fill.trade.getQuantity());
+        }
+        onFill(fill);
+    });
+}
+
+std::vector<Trade> MatchingEngine::resumeTrading(Order::InstrumentId instrument) {
+    if (halts_.isInstrumentHalted(instrument)) {
+        return {};
+    }
+    auto trades = uncrossBook(bookFor(instrument), [this](const Fill& fill) {
+        dispatcher_.onFill(fill);
+    });
     stats_.totalTradesExecuted += trades.size();
-    for (const auto& trade : trades) {
-        stats_.totalQuantityTraded += trade.getQuantity();
+    stats_.totalQuantityTraded += quantityTraded(trades);
+    return trades;
+}
+
+void MatchingEngine::haltInstrument(Order::InstrumentId instrument) {
+    if (halts_.setInstrumentHalted(instrument, true)) {
+        util::AsyncLogger::getInstance().log("Instrument {} halted.", instrument);
+    }
+}
+
+void MatchingEngine::resumeInstrument(Order::InstrumentId instrument) {
+    if (halts_.setInstrumentHalted(instrument, false)) {
+        util::AsyncLogger::getInstance().log("Instrument {} resumed.", instrument);
     }
+}
+
+void MatchingEngine::haltAccount(Order::AccountId account) {
+    if (halts_.setAccountHalted(account, true)) {
+        util::AsyncLogger::getInstance().log("Account {} halted.", account);
+    }
+}
+
+void MatchingEngine::resumeAccount(Order::AccountId account) {
+    if (halts_.setAccountHalted(account, false)) {
+        util::AsyncLogger::getInstance().log("Account {} resumed.", account);
+    }
+}
+
+size_t MatchingEngine::killAccount(Order::AccountId account) {
+    haltAccount(account);
     
-    return trades;
+    size_t canceled = 0;
+    for (auto& book : orderBooks_) {
+        for (const auto& order : book->cancelAccountOrders(account)) {
+            if (risk_) {
+                risk_->onOrderRemoved(*order, order->getRemainingQuantity());
+            }
+            canceled++;
+        }
+    }
+    util::AsyncLogger::getInstance().log("Account {} killed, {} resting orders canceled.", account, canceled);
+    return canceled;
+}
+
+void MatchingEngine::recordProcessed(size_t tradeCount, Order::Quantity quantityTraded) {
+    stats_.totalOrdersProcessed++;
+    stats_.totalTradesExecuted += tradeCount;
+    stats_.totalQuantityTraded += quantityTraded;
+}
+
+void MatchingEngine::executeCancel(const OrderRequest& request) {
+    reportCancel(applyCancel(request).get());
+}
+
+std::shared_ptr<Order> MatchingEngine::applyCancel(const OrderRequest& request) {
+    // Looked up first so the order can be reported once it has left the book
+    auto order = bookFor(request.instrument).findOrder(request.orderId);
+    bool applied = order && (request.type == OrderRequestType::CANCEL
+        ? cancelOrderSync(request.orderId, request.instrument)
+        : reduceOrderSync(request.orderId, request.quantity, request.instrument));
+    return applied ? order : nullptr;
 }
 
-const OrderBook& MatchingEngine::getOrderBook() const {
-    return orderBook_;
+void MatchingEngine::reportCancel(const Order* order) {
+    stats_.totalCancelsProcessed++;
+    if (order) {
+        dispatcher_.onOrderProcessed(*order);
+    } else {
+        stats_.totalCancelsMissed++;
+    }
+}
+
+bool MatchingEngine::cancelOrderSync(Order::OrderId orderId, Order::InstrumentId instrument) {
+    OrderBook& book = bookFor(instrument);
+    if (!risk_) {
+        return book.cancelOrder(orderId);
+    }
+    
+    // Give the canceled quantity's open notional back to the account
+    auto order = book.findOrder(orderId);
+    Order::Quantity canceled = 0;
+    if (!order || !book.cancelOrder(orderId, &canceled)) {
+        return false;
+    }
+    risk_->onOrderRemoved(*order, canceled);
+    return true;
+}
+
+bool MatchingEngine::reduceOrderSync(Order::OrderId orderId, Order::Quantity quantity,
+                                     Order::InstrumentId instrument) {
+    OrderBook& book = bookFor(instrument);
+    if (!risk_) {
+        return book.reduceOrder(orderId, quantity);
+    }
+    
+    auto order = book.findOrder(orderId);
+    Order::Quantity reduced = 0;
+    if (!order || !book.reduceOrder(orderId, quantity, &reduced)) {
+        return false;
+    }
+    risk_->onOrderRemoved(*order, reduced);
+    return true;
+}
+
+void MatchingEngine::addEventSubscriber(const std::string& name, LagPolicy policy, FanOutRing::Handler handler) {
+    if (running_) {
+        throw std::logic_error("Event subscribers must be added before the engine is started");
+    }
+    if (!fanOut_) {
+        fanOut_ = std::make_unique<FanOutRing>(fanOutCapacity_);
+    }
+    fanOut_->addSubscriber(name, policy, std::move(handler));
+}
+
+std::vector<FanOutSubscriberStats> MatchingEngine::getEventSubscriberStats() const {
+    return fanOut_ ? fanOut_->getStats() : std::vector<FanOutSubscriberStats>{};
+}
+
+std::vector<PipelineStageStats> MatchingEngine::getPipelineStats() const {
+    return pipeline_ ? pipeline_->getStageStats() : std::vector<PipelineStageStats>{};
+}
+
+const OrderBook& MatchingEngine::getOrderBook(Order::InstrumentId instrument) const {
+    return bookFor(instrument);
+}
+
+MemoryUsage MatchingEngine::getMemoryUsage() const {
+    MemoryUsage usage = orderQueue_.getMemoryUsage();
+    for (const auto& book : orderBooks_) {
+        usage += book->getMemoryUsage();
+    }
+    for (const auto& resource : pageResources_) {
+        usage.hugePageBytes += resource->explicitHugePageBytes() + resource->transparentHugePageBytes();
+    }
+    if (pipeline_) {
+        usage.bufferBytes += pipeline_->memoryBytes();
+    }
+    if (journal_) {
+        usage.bufferBytes += journal_->memoryBytes();
+    }
+    if (fanOut_) {
+        usage.bufferBytes += fanOut_->memoryBytes();
+    }
+    if (tradeStore_) {
+        usage.bufferBytes += tradeStore_->memoryBytes();
+    }
+    return usage;
+}
+
+OrderBook& MatchingEngine::bookFor(Order::InstrumentId instrument) const {
+    if (instrument >= orderBooks_.size()) {
+        throw std::out_of_range("No order book for instrument " + std::to_string(instrument));
+    }
+    return *orderBooks_[instrument];
 }
 
 void MatchingEngine::workerFunction() {
     while (running_) {
-        auto order = orderQueue_.dequeue();
+        auto request = orderQueue_.dequeue();
         
         // Check for shutdown signal
-        if (!order) break;
+        if (!request) break;
         
-        // Process the order
-        processOrderSync(order);
+        if (request->type == OrderRequestType::NEW) {
+            // Process the order; risk was checked when it was submitted
+            executeOrder(request->order);
+            dispatcher_.onOrderProcessed(*request->order);
+        } else {
+            executeCancel(*request);
+        }
+        completeOrder();
     }
 }
 
-void MatchingEngine::onTrade(const Trade& trade) {
-    // In the future, this could notify subscribers, update positions, etc.
-    std::cout << "TRADE EXECUTED: " << trade.toString() << std::endl;
-    
-    // Forward to external callback if registered
-    if (tradeCallback_) {
-        tradeCallback_(trade);
+void MatchingEngine::completeOrder() {
+    // Wake anyone waiting on the completion barrier
+    ordersCompleted_++;
+    if (completionWaiters_.load() > 0) {
+        std::lock_guard<std::mutex> lock(completionMutex_);
+        completionCv_.notify_all();
     }
 }
 
@@ -0,0 +1,242 @@
+#include "engine/NettingBatch.hpp"
+#include "engine/util/PerformanceTimer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace engine {
+
+namespace {
+
+// Partitions per thread, so merge work evens out when instruments differ in size
+constexpr std::size_t kPartitionsPerThread = 4;
+
+/**
+ * @brief Running totals of one account pair in one instrument
+ */
+struct NettingEntry {
+    std::uint64_t accounts;    // First account in the high half, second in the low half
+    std::uint32_t instrument;
+    std::uint32_t used;
+    std::int64_t quantity;     // Delivered to the first account
+    std::int64_t cash;         // Ticks x quantity paid by the first account
+    std::uint64_t gross;
+    std::uint64_t trades;
+};
+
+static_assert(sizeof(NettingEntry) == 48, "Netting entries must stay at 48 bytes");
+
+/**
+ * @brief Open-addressing hash table of netting entries, owned by one thread
+ */
+class NettingTable {
+public:
+    NettingTable() : entries_(kInitialCapacity), mask_(kInitialCapacity - 1) {}
+
+    void add(std::uint64_t accounts, std::uint32_t instrument,
+             std::int64_t quantity, std::int64_t cash, std::uint64_t gross, std::uint64_t trades) {
+        if ((size_ + 1) * 2 > entries_.size()) {
+            grow();
+        }
+        NettingEntry& entry = find(accounts, instrument);
+        if (!entry.used) {
+            entry.accounts = accounts;
+            entry.instrument = instrument;
+            entry.used = 1;
+            size_++;
+        }
+        entry.quantity += quantity;
+        entry.cash += cash;
+        entry.gross += gross;
+        entry.trades += trades;
+    }
+
+    void merge(const NettingTable& other) {
+        for (const NettingEntry& entry : other.entries_) {
+            if (entry.used) {
+                add(entry.accounts, entry.instrument, entry.quantity, entry.cash, entry.gross, entry.trades);
+            }
+        }
+    }
+
+    template<typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (const NettingEntry& entry : entries_) {
+            if (entry.used) {
+                visit(entry);
+            }
+        }
+    }
+
+    std::size_t size() const { return size_; }
+
+private:
+    static constexpr std::size_t kInitialCapacity = 64;
+
+    static std::uint64_t hash(std::uint64_t accounts, std::uint32_t instrument) {
+        // 64-bit finalizer from MurmurHash3
+        std::uint64_t h = accounts ^ (static_cast<std::uint64_t>(instrument) * 0x9e3779b97f4a7c15ULL);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    NettingEntry& find(std::uint64_t accounts, std::uint32_t instrument) {
+        std::size_t index = hash(accounts, instrument) & mask_;
+        while (entries_[index].used &&
+               (entries_[index].accounts != accounts || entries_[index].instrument != instrument)) {
+            index = (index + 1) & mask_;
+        }
+        return entries_[index];
+    }
+
+    void grow() {
+        std::vector<NettingEntry> old(entries_.size() * 2);
+        old.swap(entries_);
+        mask_ = entries_.size() - 1;
+        for (const NettingEntry& entry : old) {
+            if (entry.used) {
+                find(entry.accounts, entry.instrument) = entry;
+            }
+        }
+    }
+
+    std::vector<NettingEntry> entries_;
+    std::size_t mask_;
+    std::size_t size_ = 0;
+};
+
+} // namespace
+
+NettingBatch::NettingBatch(std::size_t numThreads)
+    : numThreads_(numThreads > 0 ? numThreads : std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+std::vector<NetObligation> NettingBatch::run(const std::string& path) {
+    TradeStoreReader reader(path);
+    return run(reader.records(), reader.size());
+}
+
+std::vector<NetObligation> NettingBatch::run(const TradeStoreRecord* records, std::size_t count) {
+    util::PerformanceTimer timer;
+    timer.start();
+
+    const std::size_t numThreads = std::max<std::size_t>(1, std::min(numThreads_, count));
+    const std::size_t numPartitions = numThreads * kPartitionsPerThread;
+
+    // Phase 1: each thread aggregates its slice into its own table per partition
+    std::vector<std::vector<NettingTable>> tables(numThreads);
+    std::vector<std::uint64_t> selfTrades(numThreads, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<NettingTable>& local = tables[t];
+            local.resize(numPartitions);
+            std::uint64_t self = 0;
+            std::size_t end = count * (t + 1) / numThreads;
+            for (std::size_t i = count * t / numThreads; i < end; ++i) {
+                const TradeStoreRecord& record = records[i];
+                if (record.buyAccount == record.sellAccount) {
+                    self++;
+                    continue;
+                }
+                // Key the pair by the lower account so both directions land in one entry
+                bool buyerFirst = record.buyAccount < record.sellAccount;
+                std::uint64_t first = buyerFirst ? record.buyAccount : record.sellAccount;
+                std::uint64_t second = buyerFirst ? record.sellAccount : record.buyAccount;
+                std::int64_t quantity = record.quantity;
+                std::int64_t cash = quantity * record.price;
+                local[record.instrument % numPartitions].add(
+                    (first << 32) | second, record.instrument,
+                    buyerFirst ? quantity : -quantity, buyerFirst ? cash : -cash, record.quantity, 1);
+            }
+            selfTrades[t] = self;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+
+    // Phase 2: threads take whole partitions and merge every thread's table for it
+    std::vector<std::vector<NetObligation>> results(numPartitions);
+    std::atomic<std::size_t> nextPartition{0};
+    for (std::size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&] {
+            std::size_t p;
+            while ((p = nextPartition.fetch_add(1)) < numPartitions) {
+                NettingTable merged;
+                for (auto& local : tables) {
+                    merged.merge(local[p]);
+                    local[p] = NettingTable();  // Free the thread's table as soon as it is merged
+                }
+
+                std::vector<NetObligation>& out = results[p];
+                out.reserve(merged.size());
+                merged.forEach([&out](const NettingEntry& entry) {
+                    out.push_back(NetObligation{
+                        entry.instrument,
+                        static_cast<Order::AccountId>(entry.accounts >> 32),
+                        static_cast<Order::AccountId>(entry.accounts & 0xffffffffULL),
+                        entry.quantity,
+                        entry.cash / Order::kTicksPerUnit,
+                        entry.gross,
+                        entry.trades
+                    });
+                });
+                std::sort(out.begin(), out.end(), [](const NetObligation& a, const NetObligation& b) {
+                    if (a.instrument != b.instrument) return a.instrument < b.instrument;
+                    if (a.firstAccount != b.firstAccount) return a.firstAccount < b.firstAccount;
+                    return a.secondAccount < b.secondAccount;
+                });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Each partition is sorted and holds whole instruments; take the runs in instrument order
+    std::size_t total = 0;
+    for (const auto& partition : results) {
+        total += partition.size();
+    }
+    std::vector<NetObligation> obligations;
+    obligations.reserve(total);
+    std::vector<std::size_t> cursors(numPartitions, 0);
+    while (obligations.size() < total) {
+        std::size_t best = numPartitions;
+        for (std::size_t p = 0; p < numPartitions; ++p) {
+            if (cursors[p] < results[p].size() &&
+                (best == numPartitions ||
+                 results[p][cursors[p]].instrument < results[best][cursors[best]].instrument)) {
+                best = p;
+            }
+        }
+        const auto& run = results[best];
+        std::size_t begin = cursors[best];
+        std::size_t end = begin;
+        while (end < run.size() && run[end].instrument == run[begin].instrument) {
+            ++end;
+        }
+        obligations.insert(obligations.end(), run.begin() + begin, run.begin() + end);
+        cursors[best] = end;
+    }
+
+    timer.stop();
+    stats_ = NettingStats();
+    stats_.trades = count;
+    for (std::uint64_t self : selfTrades) {
+        stats_.selfTrades += self;
+    }
+    stats_.obligations = obligations.size();
+    stats_.threads = numThreads;
+    stats_.partitions = numPartitions;
+    stats_.elapsedMilliseconds = timer.elapsedMilliseconds();
+    return obligations;
+}
+
+} // namespace engine
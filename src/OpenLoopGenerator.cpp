@@ -0,0 +1,89 @@
+#include "engine/bench/OpenLoopGenerator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+
+namespace engine {
+namespace bench {
+
+OpenLoopStepResult OpenLoopGenerator::runStep(double rate) const {
+    using Clock = util::PerformanceTimer::Clock;
+    
+    MatchingEngineConfig engineConfig;
+    engineConfig.numWorkers = config_.numWorkers;
+    engineConfig.numBooks = config_.numBooks;
+    engineConfig.logTrades = false;
+    MatchingEngine engine(engineConfig);
+    
+    // Pre-generate the flow so order construction does not disturb the schedule.
+    // IDs come from one contiguous range, so (id - firstId) indexes the per-order slots.
+    const size_t totalOrders = std::max<size_t>(1, static_cast<size_t>(rate * config_.stepDurationSeconds));
+    const Order::OrderId firstId = util::OrderIdGenerator::getInstance().reserveRange(totalOrders);
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(totalOrders);
+    for (size_t i = 0; i < totalOrders; ++i) {
+        orders.push_back(Order::createRandomOrderWithId(firstId + i, 90.0, 110.0, 1, 100, 0.2,
+                                                        static_cast<Order::InstrumentId>(i % config_.numBooks)));
+    }
+    
+    const auto interval = std::chrono::duration<double>(1.0 / rate);
+    std::vector<Clock::time_point> intended(totalOrders);
+    std::vector<double> latencies(totalOrders);
+    
+    engine.registerOrderCallback([&](const Order& order) {
+        size_t slot = order.getId() - firstId;
+        latencies[slot] = std::chrono::duration<double, std::micro>(Clock::now() - intended[slot]).count();
+    });
+    engine.start();
+    
+    double maxLagUs = 0.0;
+    const Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < totalOrders; ++i) {
+        intended[i] = start + std::chrono::duration_cast<Clock::duration>(interval * static_cast<double>(i));
+        
+        // Wait for the slot; if we are already late, send immediately and let the latency show it
+        Clock::time_point now = Clock::now();
+        while (now < intended[i]) {
+            std::this_thread::yield();
+            now = Clock::now();
+        }
+        maxLagUs = std::max(maxLagUs, std::chrono::duration<double, std::micro>(now - intended[i]).count());
+        
+        engine.submitOrder(orders[i]);
+    }
+    
+    engine.waitForCompletion();
+    const double elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    engine.stop();
+    
+    OpenLoopStepResult result;
+    result.targetRate = rate;
+    result.orders = totalOrders;
+    result.achievedRate = totalOrders / elapsedSeconds;
+    result.maxSendLagUs = maxLagUs;
+    result.latencyUs = util::LatencySummary::fromSamples(latencies);
+    result.saturated = result.latencyUs.p99 > config_.p99LimitUs ||
+                       result.achievedRate < rate * config_.minDeliveredRatio;
+    return result;
+}
+
+std::vector<OpenLoopStepResult> OpenLoopGenerator::findSaturation() const {
+    if (config_.rateStep <= 1.0 || config_.startRate <= 0.0) {
+        throw std::invalid_argument("Open-loop rate must start positive and step upwards");
+    }
+    
+    std::vector<OpenLoopStepResult> results;
+    
+    for (double rate = config_.startRate; rate <= config_.maxRate; rate *= config_.rateStep) {
+        results.push_back(runStep(rate));
+        if (results.back().saturated) {
+            break;
+        }
+    }
+    
+    return results;
+}
+
+} // namespace bench
+} // namespace engine
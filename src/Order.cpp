@@ -1,10 +1,13 @@
 #include "engine/Order.hpp"
-#include <sstream>
-#include <iomanip>
+#include "engine/util/CharWriter.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 
 namespace engine {
 
-Order::Order(OrderId id, OrderSide side, OrderType type, Price price, Quantity quantity)
+Order::Order(OrderId id, OrderSide side, OrderType type, Price price, Quantity quantity,
+             InstrumentId instrument, AccountId account)
     : id_(id), 
       side_(side), 
       type_(type), 
@@ -12,12 +15,16 @@ Order::Order(OrderId id, OrderSide side, OrderType type, Price price, Quantity q
       quantity_(quantity), 
       filledQuantity_(0), 
       timestamp_(std::chrono::system_clock::now()), 
-      status_(OrderStatus::NEW) {
+      status_(OrderStatus::NEW),
+      instrument_(instrument),
+      account_(account) {
 }
 
 bool Order::fill(Quantity fillQuantity) {
-    if (fillQuantity <= 0 || fillQuantity > getRemainingQuantity()) {
-        return false;
+    if (fillQuantity == 0 || fillQuantity > getRemainingQuantity()) {
+        throw std::invalid_argument("Fill of " + std::to_string(fillQuantity) + " on order " +
+                                    std::to_string(id_) + " with " + std::to_string(getRemainingQuantity()) +
+                                    " open");
     }
     
     filledQuantity_ += fillQuantity;
@@ -37,31 +44,55 @@ void Order::cancel() {
     }
 }
 
+void Order::reject() {
+    if (status_ == OrderStatus::NEW) {
+        status_ = OrderStatus::REJECTED;
+    }
+}
+
+bool Order::reduce(Quantity reduceQuantity) {
+    if (reduceQuantity == 0 || getRemainingQuantity() == 0) {
+        return false;
+    }
+    
+    quantity_ -= std::min(reduceQuantity, getRemainingQuantity());
+    
+    if (getRemainingQuantity() == 0) {
+        status_ = OrderStatus::CANCELED;
+    }
+    return true;
+}
+
 std::string Order::toString() const {
-    std::ostringstream oss;
-    oss << "Order{id=" << id_ 
-        << ", side=" << (side_ == OrderSide::BUY ? "BUY" : "SELL")
-        << ", type=" << (type_ == OrderType::LIMIT ? "LIMIT" : "MARKET");
+    char buffer[kMaxFormattedLength];
+    return std::string(buffer, formatTo(buffer, sizeof(buffer)));
+}
+
+std::size_t Order::formatTo(char* buffer, std::size_t size) const {
+    util::CharWriter out(buffer, buffer + size);
+    out.append("Order{id=").appendInteger(id_)
+       .append(", side=").append(side_ == OrderSide::BUY ? "BUY" : "SELL")
+       .append(", type=").append(type_ == OrderType::LIMIT ? "LIMIT" : "MARKET");
     
     // Only display price for limit orders
     if (type_ == OrderType::LIMIT) {
-        oss << ", price=" << std::fixed << std::setprecision(2) << price_;
+        out.append(", price=").appendFixed(std::llround(price_ * kTicksPerUnit), kTickDecimals, 2);
     }
     
-    oss << ", qty=" << quantity_
-        << ", filled=" << filledQuantity_
-        << ", status=";
-        
+    out.append(", qty=").appendInteger(quantity_)
+       .append(", filled=").appendInteger(filledQuantity_)
+       .append(", status=");
+    
     switch (status_) {
-        case OrderStatus::NEW: oss << "NEW"; break;
-        case OrderStatus::PARTIALLY_FILLED: oss << "PARTIALLY_FILLED"; break;
-        case OrderStatus::FILLED: oss << "FILLED"; break;
-        case OrderStatus::CANCELED: oss << "CANCELED"; break;
-        case OrderStatus::REJECTED: oss << "REJECTED"; break;
+        case OrderStatus::NEW: out.append("NEW"); break;
+        case OrderStatus::PARTIALLY_FILLED: out.append("PARTIALLY_FILLED"); break;
+        case OrderStatus::FILLED: out.append("FILLED"); break;
+        case OrderStatus::CANCELED: out.append("CANCELED"); break;
+        case OrderStatus::REJECTED: out.append("REJECTED"); break;
     }
     
-    oss << "}";
-    return oss.str();
+    out.append('}');
+    return out.ok() ? out.size() : 0;
 }
 
 } // namespace engine
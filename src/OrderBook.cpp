@@ -1,23 +1,34 @@
 #include "engine/OrderBook.hpp"
+#include "engine/util/AsyncLogger.hpp"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstdlib>
 
 namespace engine {
 
-OrderBook::OrderBook() = default;
+OrderBook::OrderBook(bool useArena, std::pmr::memory_resource* upstream)
+    : arena_(useArena ? std::make_unique<util::Arena>(upstream) : nullptr),
+      buyOrders_(arena_ ? arena_->resource() : std::pmr::get_default_resource()),
+      sellOrders_(arena_ ? arena_->resource() : std::pmr::get_default_resource()),
+      orderMap_(arena_ ? arena_->resource() : std::pmr::get_default_resource()) {
+}
 
-std::vector<Trade> OrderBook::addOrder(OrderPtr order, TradeCallback tradeCallback) {
-    // Lock exclusively as we're modifying the order book
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+std::vector<Trade> OrderBook::matchOrder(OrderPtr order) {
     std::vector<Trade> trades;
+    restingAccounts_.clear();
     
-    // Try to match the order first
-    if (order->getSide() == OrderSide::BUY) {
-        trades = matchBuyOrder(order, tradeCallback);
+    if (state_.load(std::memory_order_relaxed) == TradingState::AUCTION) {
+        // Limit orders are collected for the uncross; a market order has no price to collect at
+        if (order->getType() == OrderType::MARKET) {
+            order->cancel();
+        }
+    } else if (order->getSide() == OrderSide::BUY) {
+        // Try to match the order first
+        trades = matchBuyOrder(order);
     } else {
-        trades = matchSellOrder(order, tradeCallback);
+        trades = matchSellOrder(order);
     }
     
     // If the order is not fully filled, add it to the book (only for limit orders)
@@ -39,6 +50,68 @@ std::vector<Trade> OrderBook::addOrder(OrderPtr order, TradeCallback tradeCallba
     return trades;
 }
 
+bool OrderBook::cancelOrder(Order::OrderId orderId, Order::Quantity* canceledQuantity) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = orderMap_.find(orderId);
+    if (it == orderMap_.end()) {
+        return false;
+    }
+    
+    OrderPtr order = it->second;
+    if (canceledQuantity) {
+        *canceledQuantity = order->getRemainingQuantity();
+    }
+    order->cancel();
+    removeRestingOrder(order);
+    return true;
+}
+
+bool OrderBook::reduceOrder(Order::OrderId orderId, Order::Quantity quantity, Order::Quantity* reducedQuantity) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = orderMap_.find(orderId);
+    if (it == orderMap_.end()) {
+        return false;
+    }
+    
+    // Quantity is not part of the sort key, so the order can be reduced in place
+    OrderPtr order = it->second;
+    Order::Quantity openBefore = order->getRemainingQuantity();
+    if (!order->reduce(quantity)) {
+        return false;
+    }
+    if (reducedQuantity) {
+        *reducedQuantity = openBefore - order->getRemainingQuantity();
+    }
+    
+    if (order->getRemainingQuantity() == 0) {
+        removeRestingOrder(order);
+    }
+    return true;
+}
+
+std::vector<OrderBook::OrderPtr> OrderBook::cancelAccountOrders(Order::AccountId account) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    std::vector<OrderPtr> canceled;
+    for (const auto& entry : orderMap_) {
+        if (entry.second->getAccount() == account) {
+            canceled.push_back(entry.second);
+        }
+    }
+    
+    // Removed after the walk, since removal erases from the map
+    for (const OrderPtr& order : canceled) {
+        order->cancel();
+        removeRestingOrder(order);
+    }
+    return canceled;
+}
+
+OrderBook::OrderPtr OrderBook::findOrder(Order::OrderId orderId) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = orderMap_.find(orderId);
+    return it == orderMap_.end() ? nullptr : it->second;
+}
+
 Order::Price OrderBook::getBestBidPrice() const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
     if (buyOrders_.empty()) {
@@ -55,6 +128,26 @@ Order::Price OrderBook::getBestAskPrice() const {
     return (*sellOrders_.begin())->getPrice();
 }
 
+void OrderBook::setTickTable(const TickTable& table) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    tickTable_ = table;
+}
+
+TickTable OrderBook::getTickTable() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return tickTable_;
+}
+
+TickTable::Level OrderBook::getSpreadLevels() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (buyOrders_.empty() || sellOrders_.empty()) {
+        return 0;
+    }
+    TickTable::Level bid = tickTable_.levelOf(Order::toTicks((*buyOrders_.begin())->getPrice()));
+    TickTable::Level ask = tickTable_.levelOf(Order::toTicks((*sellOrders_.begin())->getPrice()));
+    return ask > bid ? ask - bid : 0;
+}
+
 std::string OrderBook::toString() const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
     std::ostringstream oss;
@@ -95,7 +188,7 @@ std::string OrderBook::toString() const {
     return oss.str();
 }
 
-std::vector<Trade> OrderBook::matchBuyOrder(OrderPtr buyOrder, TradeCallback tradeCallback) {
+std::vector<Trade> OrderBook::matchBuyOrder(OrderPtr buyOrder) {
     std::vector<Trade> trades;
     Order::Quantity remainingQty = buyOrder->getQuantity();
     
@@ -110,8 +203,15 @@ std::vector<Trade> OrderBook::matchBuyOrder(OrderPtr buyOrder, TradeCallback tra
             break;  // No more matches possible for limit orders below the best sell price
         }
         
+        // A print outside the bands interrupts trading instead
+        Order::PriceTicks tradePrice = Order::toTicks(sellOrder->getPrice());
+        if (!breaker_.allows(tradePrice)) {
+            startAuction(buyOrder->getInstrument(), tradePrice);
+            break;
+        }
+        
         // Calculate trade quantity
-        Order::Quantity tradeQty = std::min(remainingQty, sellOrder->getRemainingQuantity());
+        Order::Quantity tradeQty = std::min({remainingQty, sellOrder->getRemainingQuantity(), Trade::kMaxQuantity});
         
         // Execute the trade
         buyOrder->fill(tradeQty);
@@ -119,13 +219,11 @@ std::vector<Trade> OrderBook::matchBuyOrder(OrderPtr buyOrder, TradeCallback tra
         remainingQty -= tradeQty;
         
         // Record the trade
-        Trade trade(buyOrder->getId(), sellOrder->getId(), sellOrder->getPrice(), tradeQty);
+        Trade trade(nextTradeId_++, buyOrder->getId(), sellOrder->getId(), tradePrice,
+                    tradeQty, buyOrder->getInstrument(), OrderSide::BUY);
         trades.push_back(trade);
-        
-        // Notify via callback if provided
-        if (tradeCallback) {
-            tradeCallback(trade);
-        }
+        breaker_.onTrade(tradePrice);
+        restingAccounts_.push_back(sellOrder->getAccount());
         
         // Remove sell order from book if fully filled
         if (sellOrder->getStatus() == OrderStatus::FILLED) {
@@ -142,7 +240,7 @@ std::vector<Trade> OrderBook::matchBuyOrder(OrderPtr buyOrder, TradeCallback tra
     return trades;
 }
 
-std::vector<Trade> OrderBook::matchSellOrder(OrderPtr sellOrder, TradeCallback tradeCallback) {
+std::vector<Trade> OrderBook::matchSellOrder(OrderPtr sellOrder) {
     std::vector<Trade> trades;
     Order::Quantity remainingQty = sellOrder->getQuantity();
     
@@ -157,8 +255,15 @@ std::vector<Trade> OrderBook::matchSellOrder(OrderPtr sellOrder, TradeCallback t
             break;  // No more matches possible for limit orders above the best buy price
         }
         
+        // A print outside the bands interrupts trading instead
+        Order::PriceTicks tradePrice = Order::toTicks(buyOrder->getPrice());
+        if (!breaker_.allows(tradePrice)) {
+            startAuction(sellOrder->getInstrument(), tradePrice);
+            break;
+        }
+        
         // Calculate trade quantity
-        Order::Quantity tradeQty = std::min(remainingQty, buyOrder->getRemainingQuantity());
+        Order::Quantity tradeQty = std::min({remainingQty, buyOrder->getRemainingQuantity(), Trade::kMaxQuantity});
         
         // Execute the trade
         sellOrder->fill(tradeQty);
@@ -166,13 +271,11 @@ std::vector<Trade> OrderBook::matchSellOrder(OrderPtr sellOrder, TradeCallback t
         remainingQty -= tradeQty;
         
         // Record the trade
-        Trade trade(buyOrder->getId(), sellOrder->getId(), buyOrder->getPrice(), tradeQty);
+        Trade trade(nextTradeId_++, buyOrder->getId(), sellOrder->getId(), tradePrice,
+                    tradeQty, sellOrder->getInstrument(), OrderSide::SELL);
         trades.push_back(trade);
-        
-        // Notify via callback if provided
-        if (tradeCallback) {
-            tradeCallback(trade);
-        }
+        breaker_.onTrade(tradePrice);
+        restingAccounts_.push_back(buyOrder->getAccount());
         
         // Remove buy order from book if fully filled
         if (buyOrder->getStatus() == OrderStatus::FILLED) {
@@ -189,6 +292,150 @@ std::vector<Trade> OrderBook::matchSellOrder(OrderPtr sellOrder, TradeCallback t
     return trades;
 }
 
+void OrderBook::setCircuitBreaker(const CircuitBreakerConfig& config) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    breaker_.configure(config);
+    interruptionNanoseconds_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(config.interruption).count());
+}
+
+void OrderBook::setReferencePrice(Order::Price price) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    breaker_.setReference(Order::toTicks(price));
+}
+
+std::pair<Order::Price, Order::Price> OrderBook::getPriceBand() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return {Order::fromTicks(breaker_.getLow()), Order::fromTicks(breaker_.getHigh())};
+}
+
+void OrderBook::startAuction(Order::InstrumentId instrument, Order::PriceTicks price) {
+    state_.store(TradingState::AUCTION, std::memory_order_relaxed);
+    auctionStartNanoseconds_.store(steadyNanoseconds(), std::memory_order_relaxed);
+    interruptions_.fetch_add(1, std::memory_order_relaxed);
+    util::AsyncLogger::getInstance().log(
+        "Volatility interruption on instrument {}: trade at {} outside band {} - {}", instrument,
+        Order::fromTicks(price), Order::fromTicks(breaker_.getLow()), Order::fromTicks(breaker_.getHigh()));
+}
+
+Order::PriceTicks OrderBook::auctionPrice() const {
+    Order::PriceTicks bestBid = Order::toTicks((*buyOrders_.begin())->getPrice());
+    Order::PriceTicks bestAsk = Order::toTicks((*sellOrders_.begin())->getPrice());
+    
+    // Only crossing orders can execute: bids from the best down to the best ask, asks up to the best bid
+    std::vector<std::pair<Order::PriceTicks, Order::Quantity>> bids, asks;
+    for (const auto& order : buyOrders_) {
+        Order::PriceTicks price = Order::toTicks(order->getPrice());
+        if (price < bestAsk) break;
+        bids.emplace_back(price, order->getRemainingQuantity());
+    }
+    for (const auto& order : sellOrders_) {
+        Order::PriceTicks price = Order::toTicks(order->getPrice());
+        if (price > bestBid) break;
+        asks.emplace_back(price, order->getRemainingQuantity());
+    }
+    
+    std::vector<Order::PriceTicks> candidates;
+    for (const auto& level : bids) candidates.push_back(level.first);
+    for (const auto& level : asks) candidates.push_back(level.first);
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    
+    // Walk the candidates upwards: supply at or below the price grows, demand at or above it shrinks
+    Order::Quantity demand = 0;
+    for (const auto& level : bids) demand += level.second;
+    Order::Quantity supply = 0;
+    size_t nextAsk = 0;
+    size_t nextBid = bids.size();  // Bids are sorted high to low; consume from the low end
+    
+    Order::PriceTicks reference = breaker_.getReference() != 0 ? breaker_.getReference() : (bestBid + bestAsk) / 2;
+    Order::PriceTicks bestPrice = candidates.front();
+    Order::Quantity bestVolume = 0;
+    Order::Quantity bestImbalance = 0;
+    for (Order::PriceTicks price : candidates) {
+        while (nextAsk < asks.size() && asks[nextAsk].first <= price) {
+            supply += asks[nextAsk++].second;
+        }
+        while (nextBid > 0 && bids[nextBid - 1].first < price) {
+            demand -= bids[--nextBid].second;
+        }
+        
+        Order::Quantity volume = std::min(demand, supply);
+        Order::Quantity imbalance = demand > supply ? demand - supply : supply - demand;
+        auto distance = [reference](Order::PriceTicks p) { return std::abs(static_cast<std::int64_t>(p) - reference); };
+        if (volume > bestVolume ||
+            (volume == bestVolume && (imbalance < bestImbalance ||
+                                      (imbalance == bestImbalance && distance(price) < distance(bestPrice))))) {
+            bestPrice = price;
+            bestVolume = volume;
+            bestImbalance = imbalance;
+        }
+    }
+    return bestPrice;
+}
+
+std::vector<Trade> OrderBook::runAuction() {
+    std::vector<Trade> trades;
+    auctionMatches_.clear();
+    
+    bool crossed = !buyOrders_.empty() && !sellOrders_.empty() &&
+                   (*buyOrders_.begin())->getPrice() >= (*sellOrders_.begin())->getPrice();
+    if (crossed) {
+        Order::PriceTicks price = auctionPrice();
+        while (!buyOrders_.empty() && !sellOrders_.empty()) {
+            auto bestBuy = buyOrders_.begin();
+            auto bestSell = sellOrders_.begin();
+            OrderPtr buyOrder = *bestBuy;
+            OrderPtr sellOrder = *bestSell;
+            if (Order::toTicks(buyOrder->getPrice()) < price || Order::toTicks(sellOrder->getPrice()) > price) {
+                break;
+            }
+            
+            Order::Quantity tradeQty = std::min({buyOrder->getRemainingQuantity(), sellOrder->getRemainingQuantity(),
+                                                 Trade::kMaxQuantity});
+            buyOrder->fill(tradeQty);
+            sellOrder->fill(tradeQty);
+            
+            // The newer of the two orders is the one that crossed the book
+            OrderSide aggressor = buyOrder->getTimestamp() > sellOrder->getTimestamp() ? OrderSide::BUY : OrderSide::SELL;
+            trades.emplace_back(nextTradeId_++, buyOrder->getId(), sellOrder->getId(), price, tradeQty,
+                                buyOrder->getInstrument(), aggressor, true);
+            auctionMatches_.emplace_back(buyOrder, sellOrder);
+            
+            if (buyOrder->getStatus() == OrderStatus::FILLED) {
+                buyOrders_.erase(bestBuy);
+                orderMap_.erase(buyOrder->getId());
+            }
+            if (sellOrder->getStatus() == OrderStatus::FILLED) {
+                sellOrders_.erase(bestSell);
+                orderMap_.erase(sellOrder->getId());
+            }
+        }
+        breaker_.setReference(price);
+    }
+    
+    state_.store(TradingState::CONTINUOUS, std::memory_order_relaxed);
+    return trades;
+}
+
+void OrderBook::removeRestingOrder(const OrderPtr& order) {
+    // Orders with the same price and timestamp are equivalent, so search the range for this one
+    if (order->getSide() == OrderSide::BUY) {
+        auto range = buyOrders_.equal_range(order);
+        auto it = std::find(range.first, range.second, order);
+        if (it != range.second) {
+            buyOrders_.erase(it);
+        }
+    } else {
+        auto range = sellOrders_.equal_range(order);
+        auto it = std::find(range.first, range.second, order);
+        if (it != range.second) {
+            sellOrders_.erase(it);
+        }
+    }
+    
+    orderMap_.erase(order->getId());
+}
+
 size_t OrderBook::getBuyOrderCount() const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
     return buyOrders_.size();
@@ -199,4 +446,42 @@ size_t OrderBook::getSellOrderCount() const {
     return sellOrders_.size();
 }
 
+void OrderBook::reset() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    buyOrders_.clear();
+    sellOrders_.clear();
+    orderMap_.clear();
+    restingAccounts_.clear();
+    auctionMatches_.clear();
+    state_.store(TradingState::CONTINUOUS, std::memory_order_relaxed);
+    breaker_.setReference(0);
+    nextTradeId_ = 1;
+}
+
+MemoryUsage OrderBook::getMemoryUsage() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    MemoryUsage usage;
+    
+    // Count distinct prices on each side; each side is sorted by price first
+    auto countLevels = [](const auto& side) {
+        size_t levels = 0;
+        const Order* previous = nullptr;
+        for (const auto& order : side) {
+            if (!previous || previous->getPrice() != order->getPrice()) {
+                levels++;
+            }
+            previous = order.get();
+        }
+        return levels;
+    };
+    
+    usage.restingOrders = orderMap_.size();
+    usage.priceLevels = countLevels(buyOrders_) + countLevels(sellOrders_);
+    usage.orderBytes = usage.restingOrders * memory::kSharedOrderBytes;
+    usage.priorityTreeBytes = (buyOrders_.size() + sellOrders_.size()) * memory::treeNodeBytes(sizeof(OrderPtr));
+    usage.indexBytes = orderMap_.size() * memory::treeNodeBytes(sizeof(OrderMap::value_type));
+    usage.arenaBytes = arena_ ? arena_->reservedBytes() : 0;
+    return usage;
+}
+
 } // namespace engine
@@ -0,0 +1,95 @@
+#include "engine/OrderJournal.hpp"
+#include "engine/util/AsyncLogger.hpp"
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+
+namespace engine {
+
+namespace {
+
+std::int64_t nanosecondsSinceEpoch(Order::TimeStamp timestamp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+}
+
+} // namespace
+
+OrderJournal::OrderJournal(const std::string& path)
+    : file_(std::fopen(path.c_str(), "wb")) {
+    if (!file_) {
+        throw std::runtime_error("Cannot open journal file: " + path);
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, kBufferBytes);
+}
+
+OrderJournal::~OrderJournal() {
+    if (std::fclose(file_) != 0 && !failed_) {
+        fail();
+    }
+}
+
+bool OrderJournal::append(const Order& order) {
+    JournalRecord record{};
+    record.orderId = order.getId();
+    record.quantity = order.getQuantity();
+    record.timestampNanoseconds = nanosecondsSinceEpoch(order.getTimestamp());
+    record.price = Order::toTicks(order.getPrice());
+    record.instrument = order.getInstrument();
+    record.side = static_cast<std::uint8_t>(order.getSide());
+    record.type = static_cast<std::uint8_t>(order.getType());
+    record.account = order.getAccount();
+    return write(record);
+}
+
+bool OrderJournal::append(const OrderRequest& request) {
+    if (request.type == OrderRequestType::NEW) {
+        return append(*request.order);
+    }
+    
+    JournalRecord record{};
+    record.orderId = request.orderId;
+    record.quantity = request.quantity;
+    record.timestampNanoseconds = nanosecondsSinceEpoch(std::chrono::system_clock::now());
+    record.instrument = request.instrument;
+    record.request = static_cast<std::uint8_t>(request.type);
+    return write(record);
+}
+
+bool OrderJournal::write(const JournalRecord& record) {
+    if (failed_) {
+        recordsLost_++;
+        return false;
+    }
+    if (std::fwrite(&record, sizeof(record), 1, file_) != 1) {
+        fail();
+        recordsLost_++;
+        return false;
+    }
+    recordsWritten_++;
+    recordsBuffered_++;
+    return true;
+}
+
+bool OrderJournal::flush() {
+    if (failed_) {
+        return false;
+    }
+    if (std::fflush(file_) != 0) {
+        fail();
+        return false;
+    }
+    recordsBuffered_ = 0;
+    return true;
+}
+
+void OrderJournal::fail() {
+    int error = errno;
+    failed_ = true;
+    recordsWritten_ -= recordsBuffered_;
+    recordsLost_ += recordsBuffered_;
+    recordsBuffered_ = 0;
+    util::AsyncLogger::getInstance().log("Journal write failed (errno {}), journaling stopped; {} buffered records lost.",
+                                         error, recordsLost_);
+}
+
+} // namespace engine
@@ -0,0 +1,50 @@
+#include "engine/OrderValidator.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace engine {
+
+const char* toString(ValidationRejectReason reason) {
+    switch (reason) {
+        case ValidationRejectReason::NONE: return "NONE";
+        case ValidationRejectReason::UNKNOWN_INSTRUMENT: return "UNKNOWN_INSTRUMENT";
+        case ValidationRejectReason::INVALID_PRICE: return "INVALID_PRICE";
+        case ValidationRejectReason::QUANTITY_RANGE: return "QUANTITY_RANGE";
+        case ValidationRejectReason::LOT_SIZE: return "LOT_SIZE";
+        case ValidationRejectReason::TICK_SIZE: return "TICK_SIZE";
+        case ValidationRejectReason::PRICE_RANGE: return "PRICE_RANGE";
+        case ValidationRejectReason::COUNT: break;
+    }
+    return "UNKNOWN";
+}
+
+OrderValidator::OrderValidator(const std::vector<InstrumentSpec>& specs)
+    : specs_(specs) {
+    rules_.reserve(specs.size());
+    for (std::size_t i = 0; i < specs.size(); ++i) {
+        const InstrumentSpec& spec = specs[i];
+        std::string instrument = "instrument " + std::to_string(i);
+
+        if (spec.lotSize == 0 || spec.minQuantity == 0 || spec.minQuantity > spec.maxQuantity) {
+            throw std::invalid_argument("Lot size and quantity range of " + instrument + " are inconsistent");
+        }
+        if (!(spec.minPrice > 0 && spec.minPrice <= spec.maxPrice && spec.maxPrice <= kMaxPrice)) {
+            throw std::invalid_argument("Price range of " + instrument + " is inconsistent");
+        }
+
+        Rules rules{};
+        rules.lot = util::ExactDivisor<std::uint64_t>(spec.lotSize);
+        rules.minQuantity = spec.minQuantity;
+        rules.maxQuantity = spec.maxQuantity;
+        rules.minPrice = Order::toTicks(spec.minPrice);
+        rules.maxPrice = Order::toTicks(spec.maxPrice);
+        rules_.push_back(rules);
+        
+        // A single tick size is a table with one band from the smallest positive price
+        tickTables_.push_back(spec.tickBands.empty()
+            ? TickTable({TickBand{spec.tickSize, spec.tickSize}})
+            : TickTable(spec.tickBands));
+    }
+}
+
+} // namespace engine
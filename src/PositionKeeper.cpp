@@ -0,0 +1,119 @@
+#include "engine/PositionKeeper.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace engine {
+
+PositionKeeper::PositionKeeper(std::size_t numAccounts, std::size_t numInstruments)
+    : numAccounts_(numAccounts),
+      numInstruments_(numInstruments),
+      cells_(numAccounts * numInstruments),
+      lastPrices_(numInstruments) {
+    if (numAccounts == 0 || numInstruments == 0) {
+        throw std::invalid_argument("Position keeper needs at least one account and one instrument");
+    }
+}
+
+void PositionKeeper::onFill(const Fill& fill) {
+    const Trade& trade = fill.trade;
+    Order::InstrumentId instrument = trade.getInstrument();
+    if (instrument >= numInstruments_ || fill.buyAccount >= numAccounts_ || fill.sellAccount >= numAccounts_) {
+        ignoredFills_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto quantity = static_cast<std::int64_t>(trade.getQuantity());
+    lastPrices_[instrument].store(trade.getPriceTicks(), std::memory_order_relaxed);
+    apply(cell(fill.buyAccount, instrument), quantity, trade.getPriceTicks());
+    apply(cell(fill.sellAccount, instrument), -quantity, trade.getPriceTicks());
+    appliedFills_.store(appliedFills_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void PositionKeeper::apply(Cell& cell, std::int64_t quantity, Order::PriceTicks price) {
+    std::int64_t position = cell.position.load(std::memory_order_relaxed);
+    std::int64_t cost = cell.cost.load(std::memory_order_relaxed);
+    std::int64_t realized = cell.realized.load(std::memory_order_relaxed);
+
+    if (position == 0 || (position > 0) == (quantity > 0)) {
+        // Opening or adding to the position
+        cost += quantity * price;
+        position += quantity;
+    } else {
+        // Closing against the average cost; whatever is left over opens the other way
+        std::int64_t closing = std::min(std::abs(quantity), std::abs(position));
+        std::int64_t closedCost = closing == std::abs(position)
+            ? cost
+            : std::llround(static_cast<double>(cost) * closing / std::abs(position));
+        std::int64_t closedQuantity = position > 0 ? closing : -closing;
+        realized += closedQuantity * price - closedCost;
+        cost -= closedCost;
+        position -= closedQuantity;
+
+        std::int64_t opening = quantity + closedQuantity;
+        cost += opening * price;
+        position += opening;
+    }
+
+    // Seqlock write: odd sequence, then the fields, then the next even sequence
+    std::uint32_t sequence = cell.sequence.load(std::memory_order_relaxed);
+    cell.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    cell.position.store(position, std::memory_order_relaxed);
+    cell.cost.store(cost, std::memory_order_relaxed);
+    cell.realized.store(realized, std::memory_order_relaxed);
+    cell.volume.store(cell.volume.load(std::memory_order_relaxed) + static_cast<std::uint64_t>(std::abs(quantity)),
+                      std::memory_order_relaxed);
+    cell.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+PositionSnapshot PositionKeeper::getPosition(Order::AccountId account, Order::InstrumentId instrument) const {
+    if (account >= numAccounts_ || instrument >= numInstruments_) {
+        throw std::out_of_range("No position for account " + std::to_string(account) +
+                                " in instrument " + std::to_string(instrument));
+    }
+    const Cell& c = cells_[static_cast<std::size_t>(account) * numInstruments_ + instrument];
+
+    std::int64_t position, cost, realized;
+    std::uint64_t volume;
+    while (true) {
+        std::uint32_t before = c.sequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0) {
+            position = c.position.load(std::memory_order_relaxed);
+            cost = c.cost.load(std::memory_order_relaxed);
+            realized = c.realized.load(std::memory_order_relaxed);
+            volume = c.volume.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (c.sequence.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        snapshotRetries_.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::yield();
+    }
+
+    Order::PriceTicks last = lastPrices_[instrument].load(std::memory_order_relaxed);
+    PositionSnapshot snapshot;
+    snapshot.account = account;
+    snapshot.instrument = instrument;
+    snapshot.netPosition = position;
+    snapshot.averagePrice = position != 0 ? static_cast<double>(cost) / position / Order::kTicksPerUnit : 0.0;
+    snapshot.realizedPnl = realized / Order::kTicksPerUnit;
+    snapshot.unrealizedPnl = last > 0 ? (static_cast<double>(position) * last - cost) / Order::kTicksPerUnit : 0.0;
+    snapshot.volume = volume;
+    snapshot.lastPrice = Order::fromTicks(last);
+    return snapshot;
+}
+
+std::vector<PositionSnapshot> PositionKeeper::getAccountPositions(Order::AccountId account) const {
+    std::vector<PositionSnapshot> positions;
+    positions.reserve(numInstruments_);
+    for (std::size_t instrument = 0; instrument < numInstruments_; ++instrument) {
+        positions.push_back(getPosition(account, static_cast<Order::InstrumentId>(instrument)));
+    }
+    return positions;
+}
+
+} // namespace engine
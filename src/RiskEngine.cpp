@@ -0,0 +1,131 @@
+#include "engine/RiskEngine.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace engine {
+
+namespace {
+
+constexpr std::int64_t kPartsPerMillion = 1000000;
+
+// Largest limit price that still fits in PriceTicks
+const Order::Price kMaxPrice = std::numeric_limits<Order::PriceTicks>::max() / Order::kTicksPerUnit;
+
+std::int64_t toNotionalTicks(double amount) {
+    return static_cast<std::int64_t>(std::llround(amount * Order::kTicksPerUnit));
+}
+
+} // namespace
+
+const char* toString(RiskRejectReason reason) {
+    switch (reason) {
+        case RiskRejectReason::NONE: return "NONE";
+        case RiskRejectReason::UNKNOWN_ACCOUNT: return "UNKNOWN_ACCOUNT";
+        case RiskRejectReason::INVALID_ORDER: return "INVALID_ORDER";
+        case RiskRejectReason::ORDER_QUANTITY: return "ORDER_QUANTITY";
+        case RiskRejectReason::ORDER_NOTIONAL: return "ORDER_NOTIONAL";
+        case RiskRejectReason::PRICE_BAND: return "PRICE_BAND";
+        case RiskRejectReason::POSITION: return "POSITION";
+        case RiskRejectReason::OPEN_NOTIONAL: return "OPEN_NOTIONAL";
+        case RiskRejectReason::COUNT: break;
+    }
+    return "UNKNOWN";
+}
+
+RiskEngine::RiskEngine(std::size_t numAccounts, std::size_t numInstruments, const RiskLimits& limits)
+    : limits_(limits),
+      numInstruments_(numInstruments),
+      maxOrderNotionalTicks_(toNotionalTicks(limits.maxOrderNotional)),
+      maxOpenNotionalTicks_(toNotionalTicks(limits.maxOpenNotional)),
+      priceBandPpm_(std::llround(limits.priceBand * kPartsPerMillion)),
+      openNotional_(numAccounts),
+      positions_(numAccounts * numInstruments),
+      lastPrices_(numInstruments) {
+    if (numAccounts == 0 || numInstruments == 0) {
+        throw std::invalid_argument("Risk engine needs at least one account and one instrument");
+    }
+    if (limits.maxOrderNotional < 0 || limits.maxOpenNotional < 0 || limits.priceBand < 0 ||
+        limits.maxPosition < 0) {
+        throw std::invalid_argument("Risk limits must not be negative");
+    }
+}
+
+RiskRejectReason RiskEngine::check(const Order& order) {
+    checked_.fetch_add(1, std::memory_order_relaxed);
+
+    Order::AccountId account = order.getAccount();
+    Order::InstrumentId instrument = order.getInstrument();
+    if (account >= openNotional_.size() || instrument >= numInstruments_) {
+        return reject(RiskRejectReason::UNKNOWN_ACCOUNT);
+    }
+
+    Order::Quantity quantity = order.getQuantity();
+    bool limit = order.getType() == OrderType::LIMIT;
+    if (quantity == 0 ||
+        (limit && !(order.getPrice() > 0 && order.getPrice() <= kMaxPrice))) {
+        return reject(RiskRejectReason::INVALID_ORDER);
+    }
+    if (quantity > limits_.maxOrderQuantity) {
+        return reject(RiskRejectReason::ORDER_QUANTITY);
+    }
+
+    // Market orders are priced at the last trade; before the first trade they have no notional
+    Order::PriceTicks lastPrice = lastPrices_[instrument].load(std::memory_order_relaxed);
+    Order::PriceTicks price = limit ? Order::toTicks(order.getPrice()) : lastPrice;
+    std::int64_t orderNotional = notional(price, quantity);
+    if (orderNotional > maxOrderNotionalTicks_) {
+        return reject(RiskRejectReason::ORDER_NOTIONAL);
+    }
+
+    if (limit && lastPrice > 0) {
+        std::int64_t distance = std::abs(static_cast<std::int64_t>(price) - lastPrice);
+        if (distance * kPartsPerMillion > static_cast<std::int64_t>(lastPrice) * priceBandPpm_) {
+            return reject(RiskRejectReason::PRICE_BAND);
+        }
+    }
+
+    // Worst case: the whole order fills on top of the current position
+    std::int64_t signedQuantity = order.getSide() == OrderSide::BUY
+        ? static_cast<std::int64_t>(quantity) : -static_cast<std::int64_t>(quantity);
+    std::int64_t position = positions_[positionIndex(account, instrument)].load(std::memory_order_relaxed);
+    if (std::abs(position + signedQuantity) > limits_.maxPosition) {
+        return reject(RiskRejectReason::POSITION);
+    }
+
+    // Reserve first and back out on overshoot, so concurrent checks cannot both pass the limit
+    if (limit) {
+        std::atomic<std::int64_t>& open = openNotional_[account];
+        if (open.fetch_add(orderNotional, std::memory_order_relaxed) + orderNotional > maxOpenNotionalTicks_) {
+            open.fetch_sub(orderNotional, std::memory_order_relaxed);
+            return reject(RiskRejectReason::OPEN_NOTIONAL);
+        }
+    }
+
+    return RiskRejectReason::NONE;
+}
+
+void RiskEngine::onFill(const Fill& fill) {
+    const Trade& trade = fill.trade;
+    Order::InstrumentId instrument = trade.getInstrument();
+    if (instrument >= numInstruments_ ||
+        fill.buyAccount >= openNotional_.size() || fill.sellAccount >= openNotional_.size()) {
+        return;
+    }
+
+    auto quantity = static_cast<std::int64_t>(trade.getQuantity());
+    positions_[positionIndex(fill.buyAccount, instrument)].fetch_add(quantity, std::memory_order_relaxed);
+    positions_[positionIndex(fill.sellAccount, instrument)].fetch_sub(quantity, std::memory_order_relaxed);
+    lastPrices_[instrument].store(trade.getPriceTicks(), std::memory_order_relaxed);
+
+    // Both sides of an auction trade rested at their own limits; the engine releases those per order
+    if (trade.isAuction()) {
+        return;
+    }
+
+    // The resting order traded at its own limit price, which is what it reserved
+    Order::AccountId resting = trade.getAggressorSide() == OrderSide::BUY ? fill.sellAccount : fill.buyAccount;
+    release(resting, notional(trade.getPriceTicks(), trade.getQuantity()));
+}
+
+} // namespace engine
@@ -0,0 +1,72 @@
+#include "engine/TickTable.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace engine {
+
+namespace {
+
+constexpr std::int64_t kMaxTicks = std::numeric_limits<Order::PriceTicks>::max();
+
+std::int64_t wholeTicks(Order::Price price, const char* what) {
+    double ticks = price * Order::kTicksPerUnit;
+    if (!(ticks >= 0 && ticks <= kMaxTicks) || std::abs(ticks - std::round(ticks)) > 1e-6) {
+        throw std::invalid_argument(std::string(what) + " is not a whole number of price ticks");
+    }
+    return std::llround(ticks);
+}
+
+} // namespace
+
+TickTable::TickTable()
+    : TickTable({TickBand{1 / Order::kTicksPerUnit, 1 / Order::kTicksPerUnit}}) {
+}
+
+TickTable::TickTable(const std::vector<TickBand>& bands) {
+    if (bands.empty() || bands.size() > kMaxBands) {
+        throw std::invalid_argument("A tick table needs 1 to " + std::to_string(kMaxBands) + " bands");
+    }
+
+    starts_.fill(kMaxTicks + 1);
+    levels_.fill(std::numeric_limits<Level>::max());
+
+    for (std::size_t i = 0; i < bands.size(); ++i) {
+        starts_[i] = wholeTicks(bands[i].from, "Tick band start");
+        std::int64_t tick = wholeTicks(bands[i].tickSize, "Tick size");
+        if (tick == 0) {
+            throw std::invalid_argument("Tick size must be positive");
+        }
+        ticks_[i] = util::ExactDivisor<std::uint32_t>(static_cast<std::uint32_t>(tick));
+
+        if (i == 0) {
+            levels_[i] = 0;
+            continue;
+        }
+        // The boundary must be a level of the band below, so numbering continues without a gap
+        if (starts_[i] <= starts_[i - 1]) {
+            throw std::invalid_argument("Tick bands must be in ascending price order");
+        }
+        auto distance = static_cast<std::uint32_t>(starts_[i] - starts_[i - 1]);
+        if (!ticks_[i - 1].divides(distance)) {
+            throw std::invalid_argument("Tick band starting at " + std::to_string(bands[i].from) +
+                                        " is not on the grid of the band below");
+        }
+        levels_[i] = levels_[i - 1] + ticks_[i - 1].divide(distance);
+    }
+
+    numBands_ = bands.size();
+    std::size_t last = numBands_ - 1;
+    numLevels_ = levels_[last] + static_cast<Level>((kMaxTicks - starts_[last]) / ticks_[last].getDivisor()) + 1;
+}
+
+std::vector<TickBand> TickTable::getBands() const {
+    std::vector<TickBand> bands;
+    for (std::size_t i = 0; i < numBands_; ++i) {
+        bands.push_back(TickBand{Order::fromTicks(static_cast<Order::PriceTicks>(starts_[i])),
+                                 Order::fromTicks(static_cast<Order::PriceTicks>(ticks_[i].getDivisor()))});
+    }
+    return bands;
+}
+
+} // namespace engine
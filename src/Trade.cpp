@@ -1,25 +1,39 @@
 #include "engine/Trade.hpp"
-#include <sstream>
-#include <iomanip>
+#include "engine/util/CharWriter.hpp"
 
 namespace engine {
 
-Trade::Trade(Order::OrderId buyOrderId, Order::OrderId sellOrderId, 
-             Order::Price price, Order::Quantity quantity)
+Trade::Trade(TradeId tradeId, Order::OrderId buyOrderId, Order::OrderId sellOrderId,
+             Order::PriceTicks price, Order::Quantity quantity,
+             Order::InstrumentId instrument, OrderSide aggressorSide, bool auction)
     : buyOrderId_(buyOrderId), 
       sellOrderId_(sellOrderId), 
       price_(price), 
-      quantity_(quantity), 
-      timestamp_(std::chrono::system_clock::now()) {
+      quantity_(static_cast<TradeQuantity>(quantity)), 
+      tradeId_(tradeId),
+      instrument_(static_cast<std::uint16_t>(instrument)),
+      aggressorSide_(static_cast<std::uint8_t>(aggressorSide)),
+      auction_(auction ? 1 : 0) {
 }
 
 std::string Trade::toString() const {
-    std::ostringstream oss;
-    oss << "Trade{buy=" << buyOrderId_ 
-        << ", sell=" << sellOrderId_
-        << ", price=" << std::fixed << std::setprecision(2) << price_
-        << ", qty=" << quantity_ << "}";
-    return oss.str();
+    char buffer[kMaxFormattedLength];
+    return std::string(buffer, formatTo(buffer, sizeof(buffer)));
+}
+
+std::size_t Trade::formatTo(char* buffer, std::size_t size) const {
+    util::CharWriter out(buffer, buffer + size);
+    out.append("Trade{id=").appendInteger(tradeId_)
+       .append(", buy=").appendInteger(buyOrderId_)
+       .append(", sell=").appendInteger(sellOrderId_)
+       .append(", price=").appendFixed(price_, Order::kTickDecimals, 2)
+       .append(", qty=").appendInteger(quantity_)
+       .append(", aggressor=").append(getAggressorSide() == OrderSide::BUY ? "BUY" : "SELL");
+    if (auction_) {
+        out.append(", auction");
+    }
+    out.append('}');
+    return out.ok() ? out.size() : 0;
 }
 
 } // namespace engine
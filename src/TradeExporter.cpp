@@ -0,0 +1,78 @@
+#include "engine/TradeExporter.hpp"
+#include "engine/util/CharWriter.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace engine {
+
+namespace {
+
+constexpr char kCsvHeader[] = "trade_id,instrument,buy_order_id,sell_order_id,price,quantity,aggressor\n";
+
+const char* sideName(OrderSide side) {
+    return side == OrderSide::BUY ? "BUY" : "SELL";
+}
+
+} // namespace
+
+TradeExporter::TradeExporter(std::ostream& out, TradeExportFormat format, std::size_t bufferBytes)
+    : out_(out),
+      format_(format),
+      buffer_(std::max(bufferBytes, kMaxLineBytes)) {
+}
+
+TradeExporter::~TradeExporter() {
+    flush();
+}
+
+void TradeExporter::write(const Trade* trades, std::size_t count) {
+    if (format_ == TradeExportFormat::CSV && !headerWritten_) {
+        std::memcpy(buffer_.data() + used_, kCsvHeader, sizeof(kCsvHeader) - 1);
+        used_ += sizeof(kCsvHeader) - 1;
+        headerWritten_ = true;
+    }
+    
+    for (std::size_t i = 0; i < count; ++i) {
+        if (buffer_.size() - used_ < kMaxLineBytes) {
+            flush();
+        }
+        char* line = buffer_.data() + used_;
+        used_ += format_ == TradeExportFormat::CSV ? formatCsv(trades[i], line) : formatJson(trades[i], line);
+    }
+    tradesWritten_ += count;
+}
+
+void TradeExporter::flush() {
+    if (used_ == 0) {
+        return;
+    }
+    out_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+    bytesFlushed_ += used_;
+    used_ = 0;
+}
+
+std::size_t TradeExporter::formatCsv(const Trade& trade, char* buffer) {
+    util::CharWriter line(buffer, buffer + kMaxLineBytes);
+    line.appendInteger(trade.getTradeId()).append(',')
+        .appendInteger(trade.getInstrument()).append(',')
+        .appendInteger(trade.getBuyOrderId()).append(',')
+        .appendInteger(trade.getSellOrderId()).append(',')
+        .appendFixed(trade.getPriceTicks(), Order::kTickDecimals, Order::kTickDecimals).append(',')
+        .appendInteger(trade.getQuantity()).append(',')
+        .append(sideName(trade.getAggressorSide())).append('\n');
+    return line.size();
+}
+
+std::size_t TradeExporter::formatJson(const Trade& trade, char* buffer) {
+    util::CharWriter line(buffer, buffer + kMaxLineBytes);
+    line.append("{\"trade_id\":").appendInteger(trade.getTradeId())
+        .append(",\"instrument\":").appendInteger(trade.getInstrument())
+        .append(",\"buy_order_id\":").appendInteger(trade.getBuyOrderId())
+        .append(",\"sell_order_id\":").appendInteger(trade.getSellOrderId())
+        .append(",\"price\":").appendFixed(trade.getPriceTicks(), Order::kTickDecimals, Order::kTickDecimals)
+        .append(",\"quantity\":").appendInteger(trade.getQuantity())
+        .append(",\"aggressor\":\"").append(sideName(trade.getAggressorSide())).append("\"}\n");
+    return line.size();
+}
+
+} // namespace engine
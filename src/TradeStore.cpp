@@ -0,0 +1,92 @@
+#include "engine/TradeStore.hpp"
+#include "engine/util/AsyncLogger.hpp"
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+
+namespace engine {
+
+TradeStoreWriter::TradeStoreWriter(const std::string& path)
+    : file_(std::fopen(path.c_str(), "wb")) {
+    if (!file_) {
+        throw std::runtime_error("Cannot open trade store file: " + path);
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, kBufferBytes);
+}
+
+TradeStoreWriter::~TradeStoreWriter() {
+    close();
+}
+
+bool TradeStoreWriter::append(const Fill& fill) {
+    if (failed_ || !file_) {
+        recordsLost_++;
+        return false;
+    }
+
+    const Trade& trade = fill.trade;
+    TradeStoreRecord record{};
+    record.timestampNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        fill.timestamp.time_since_epoch()).count();
+    record.buyOrderId = trade.getBuyOrderId();
+    record.sellOrderId = trade.getSellOrderId();
+    record.buyAccount = fill.buyAccount;
+    record.sellAccount = fill.sellAccount;
+    record.price = trade.getPriceTicks();
+    record.quantity = static_cast<std::uint32_t>(trade.getQuantity());
+    record.tradeId = trade.getTradeId();
+    record.instrument = static_cast<std::uint16_t>(trade.getInstrument());
+    record.aggressorSide = static_cast<std::uint8_t>(trade.getAggressorSide());
+
+    if (std::fwrite(&record, sizeof(record), 1, file_) != 1) {
+        fail();
+        recordsLost_++;
+        return false;
+    }
+    recordsWritten_++;
+    recordsBuffered_++;
+    return true;
+}
+
+bool TradeStoreWriter::flush() {
+    if (failed_ || !file_) {
+        return false;
+    }
+    if (std::fflush(file_) != 0) {
+        fail();
+        return false;
+    }
+    recordsBuffered_ = 0;
+    return true;
+}
+
+bool TradeStoreWriter::close() {
+    if (!file_) {
+        return !failed_;
+    }
+    flush();
+    if (std::fclose(file_) != 0 && !failed_) {
+        fail();
+    }
+    file_ = nullptr;
+    return !failed_;
+}
+
+void TradeStoreWriter::fail() {
+    int error = errno;
+    failed_ = true;
+    recordsWritten_ -= recordsBuffered_;
+    recordsLost_ += recordsBuffered_;
+    recordsBuffered_ = 0;
+    util::AsyncLogger::getInstance().log("Trade store write failed (errno {}), store disabled; {} buffered records lost.",
+                                         error, recordsLost_);
+}
+
+TradeStoreReader::TradeStoreReader(const std::string& path)
+    : file_(path) {
+    if (file_.size() % sizeof(TradeStoreRecord) != 0) {
+        throw std::runtime_error("Trade store file is not a whole number of records: " + path);
+    }
+}
+
+} // namespace engine
@@ -0,0 +1,47 @@
+#include "engine/TradingHalts.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace engine {
+
+TradingHalts::TradingHalts(std::size_t numInstruments, std::size_t numAccounts)
+    : instruments_(numInstruments),
+      accounts_(numAccounts) {
+}
+
+bool TradingHalts::setInstrumentHalted(Order::InstrumentId instrument, bool halted) {
+    if (instrument >= instruments_.size()) {
+        throw std::out_of_range("No halt flag for instrument " + std::to_string(instrument));
+    }
+    return setFlag(instruments_[instrument], halted);
+}
+
+bool TradingHalts::setAccountHalted(Order::AccountId account, bool halted) {
+    if (account >= accounts_.size()) {
+        throw std::out_of_range("No halt flag for account " + std::to_string(account));
+    }
+    return setFlag(accounts_[account], halted);
+}
+
+bool TradingHalts::isHalted(const Order& order) const {
+    if (isInstrumentHalted(order.getInstrument()) || isAccountHalted(order.getAccount())) {
+        blocked_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool TradingHalts::setFlag(std::atomic<std::uint8_t>& flag, bool halted) {
+    // The count goes up after the flag is set and down after it is cleared, so it never hides a set flag
+    if (flag.exchange(halted ? 1 : 0, std::memory_order_acq_rel) == (halted ? 1 : 0)) {
+        return false;
+    }
+    if (halted) {
+        active_.fetch_add(1, std::memory_order_release);
+    } else {
+        active_.fetch_sub(1, std::memory_order_release);
+    }
+    return true;
+}
+
+} // namespace engine
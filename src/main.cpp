@@ -1,5 +1,11 @@
 #include "engine/MatchingEngine.hpp"
 #include "engine/util/PerformanceTimer.hpp"
+#include "engine/replay/ItchReplayer.hpp"
+#include "engine/bench/OpenLoopGenerator.hpp"
+#include "engine/util/ProcessMemory.hpp"
+#include "engine/util/AsyncLogger.hpp"
+#include "engine/TradeExporter.hpp"
+#include "engine/NettingBatch.hpp"
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -8,31 +14,27 @@
 #include <chrono>
 #include <random>
 #include <atomic>
-#include <mutex>
 #include <iomanip>
 #include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <limits>
 
 using namespace engine;
 using namespace engine::util;
+using namespace engine::replay;
+using namespace engine::bench;
 using namespace std::chrono_literals;
 
-// Mutex for clean console output
-std::mutex coutMutex;
-
-// Thread-safe console output helper
-template<typename... Args>
-void printThreadSafe(Args&&... args) {
-    std::lock_guard<std::mutex> lock(coutMutex);
-    (std::cout << ... << std::forward<Args>(args));
-    std::cout << std::endl;
-}
-
 // Order producer function - generates and submits random orders
 void orderProducer(
     MatchingEngine& engine, 
     int numOrders, 
     int delayMs = 0,
-    std::string producerName = "Producer") {
+    int producerNumber = 1) {
+    
+    AsyncLogger& logger = AsyncLogger::getInstance();
     
     for (int i = 0; i < numOrders; ++i) {
         // Create a random order
@@ -41,13 +43,9 @@ void orderProducer(
         // Submit to the matching engine
         engine.submitOrder(order);
         
-        printThreadSafe(
-            producerName, " submitted ", 
-            (order->getSide() == OrderSide::BUY ? "BUY" : "SELL"), 
-            " order: price=", std::fixed, std::setprecision(2), order->getPrice(), 
-            " qty=", order->getQuantity(), 
-            " [", i + 1, "/", numOrders, "]"
-        );
+        logger.log("Producer-{} submitted {} order: price={} qty={} [{}/{}]",
+                   producerNumber, (order->getSide() == OrderSide::BUY ? "BUY" : "SELL"),
+                   order->getPrice(), order->getQuantity(), i + 1, numOrders);
         
         // Optional delay between orders
         if (delayMs > 0) {
@@ -80,6 +78,7 @@ void runBasicDemo(MatchingEngine& engine) {
     // Demonstrate matching - this order will match with a sell order
     std::cout << "\nAdding a new BUY order that will match:" << std::endl;
     auto trades1 = engine.processOrderSync(Order::createOrder(OrderSide::BUY, OrderType::LIMIT, 102.0, 5));
+    AsyncLogger::getInstance().flush();  // Show the logged trades before the summary
     std::cout << "Trades executed: " << trades1.size() << std::endl;
     
     // Print the updated order book
@@ -89,6 +88,7 @@ void runBasicDemo(MatchingEngine& engine) {
     // Add a sell order that matches multiple buy orders
     std::cout << "\nAdding a new SELL order that will match multiple BUY orders:" << std::endl;
     auto trades2 = engine.processOrderSync(Order::createOrder(OrderSide::SELL, OrderType::LIMIT, 98.0, 50));
+    AsyncLogger::getInstance().flush();
     std::cout << "Trades executed: " << trades2.size() << std::endl;
     
     // Print the final order book
@@ -120,13 +120,12 @@ void runConcurrentDemo(int numProducers, int ordersPerProducer) {
     
     timer.start();
     for (int i = 0; i < numProducers; ++i) {
-        std::string name = "Producer-" + std::to_string(i+1);
         producers.emplace_back(
             orderProducer, 
             std::ref(engine), 
             ordersPerProducer, 
             0, // No delay between orders for maximum throughput
-            name
+            i + 1
         );
     }
     
@@ -135,10 +134,11 @@ void runConcurrentDemo(int numProducers, int ordersPerProducer) {
         producer.join();
     }
     
-    // Wait a bit to process any remaining orders
-    std::this_thread::sleep_for(500ms);
+    // Wait until every submitted order has been processed
+    engine.waitForCompletion();
     
     timer.stop();
+    AsyncLogger::getInstance().flush();
     
     // Print the final order book
     std::cout << "\nFinal Order Book:" << std::endl;
@@ -169,46 +169,63 @@ void runPerformanceBenchmark() {
     MatchingEngine engine(1);
     engine.start();
     
-    // Create a batch of random orders
-    const int batchSize = 1000;
+    // Create random orders for both runs (warm-up included); each order is submitted once
+    const int batchSize = 103 * 10 + 103 * 100;
     std::vector<std::shared_ptr<Order>> orders;
     orders.reserve(batchSize);
     
     for (int i = 0; i < batchSize; ++i) {
         orders.push_back(Order::createRandomOrder());
     }
+    size_t next = 0;
     
     // Benchmark synchronous order processing (direct)
     PerformanceBenchmark::runBenchmark(
         "Synchronous Order Processing",
-        [&engine, &orders]() {
+        [&engine, &orders, &next]() {
             // Process 10 orders per benchmark iteration
             for (int i = 0; i < 10; ++i) {
-                int idx = i % orders.size();
-                engine.processOrderSync(orders[idx]);
+                engine.processOrderSync(orders[next++ % orders.size()]);
             }
         },
-        100
+        100, 3, 10
     );
     
     // Benchmark asynchronous order submission
     PerformanceBenchmark::runBenchmark(
         "Asynchronous Order Submission",
-        [&engine, &orders]() {
+        [&engine, &orders, &next]() {
             // Submit 100 orders per benchmark iteration
             for (int i = 0; i < 100; ++i) {
-                int idx = i % orders.size();
-                engine.submitOrder(orders[idx]);
+                engine.submitOrder(orders[next++ % orders.size()]);
             }
         },
-        100
+        100, 3, 100
     );
     
     // Wait for all orders to be processed
-    std::this_thread::sleep_for(1s);
+    engine.waitForCompletion();
     
     // Clean up
     engine.stop();
+    
+    // Cost of logging a trade on the calling thread; formatting happens on the
+    // logger's background thread and the text is discarded
+    std::ostream discard(nullptr);
+    AsyncLogger logger(discard, 16384);  // Holds every record of the run, so none are dropped
+    Trade trade(1, 1, 2, Order::toTicks(100.0), 10, 0, OrderSide::BUY);
+    PerformanceBenchmark::runBenchmark(
+        "Asynchronous Trade Logging",
+        [&logger, &trade]() {
+            for (int i = 0; i < 100; ++i) {
+                logger.log("TRADE EXECUTED: {}", trade);
+            }
+        },
+        100, 3, 100
+    );
+    logger.flush();
+    std::cout << "  Records written: " << logger.writtenRecords()
+              << ", dropped: " << logger.droppedRecords() << std::endl;
 }
 
 // Demo specifically for market orders
@@ -239,6 +256,7 @@ void runMarketOrderDemo(MatchingEngine& engine) {
     std::cout << "\nAdding a market BUY order for 10 units:" << std::endl;
     auto marketBuy = Order::createMarketOrder(OrderSide::BUY, 10);
     auto tradesBuy = engine.processOrderSync(marketBuy);
+    AsyncLogger::getInstance().flush();
     std::cout << "Market buy order: " << marketBuy->toString() << std::endl;
     std::cout << "Trades executed: " << tradesBuy.size() << std::endl;
     for (const auto& trade : tradesBuy) {
@@ -253,6 +271,7 @@ void runMarketOrderDemo(MatchingEngine& engine) {
     std::cout << "\nAdding a market SELL order for 25 units:" << std::endl;
     auto marketSell = Order::createMarketOrder(OrderSide::SELL, 25);
     auto tradesSell = engine.processOrderSync(marketSell);
+    AsyncLogger::getInstance().flush();
     std::cout << "Market sell order: " << marketSell->toString() << std::endl;
     std::cout << "Trades executed: " << tradesSell.size() << std::endl;
     for (const auto& trade : tradesSell) {
@@ -267,6 +286,7 @@ void runMarketOrderDemo(MatchingEngine& engine) {
     std::cout << "\nAdding a market BUY order for 100 units (will be partially filled):" << std::endl;
     auto largeBuy = Order::createMarketOrder(OrderSide::BUY, 100);
     auto tradesPartial = engine.processOrderSync(largeBuy);
+    AsyncLogger::getInstance().flush();
     std::cout << "Large market buy order: " << largeBuy->toString() << std::endl;
     std::cout << "Trades executed: " << tradesPartial.size() << std::endl;
     for (const auto& trade : tradesPartial) {
@@ -280,7 +300,1744 @@ void runMarketOrderDemo(MatchingEngine& engine) {
     engine.stop();
 }
 
+// Replay of an ITCH 5.0 message file through the matching engine
+void runItchReplayBenchmark(const std::string& path, ReplayPace pace = ReplayPace::MAXIMUM, double speed = 1.0,
+                            size_t cancelPriorityRun = 0) {
+    std::cout << "\n==== ITCH Replay Benchmark ====" << std::endl;
+    std::cout << "Replaying " << path
+              << (pace == ReplayPace::RECORDED ? " at recorded speed" : " at maximum speed") << std::endl;
+    if (cancelPriorityRun > 0) {
+        std::cout << "Cancels sequenced first within a timestamp, up to " << cancelPriorityRun << " in a row" << std::endl;
+    }
+    
+    ItchReader reader(path);
+    
+    // Time the decoder on its own so we can check it never limits the replay
+    ItchMessage msg{};
+    uint64_t decoded = 0;
+    PerformanceTimer decodeTimer;
+    decodeTimer.start();
+    while (reader.next(msg)) {
+        decoded++;
+    }
+    decodeTimer.stop();
+    reader.rewind();
+    
+    MatchingEngine engine(1);
+    engine.start();
+    
+    ItchReplayOptions options;
+    options.pace = pace;
+    options.speed = speed;
+    options.cancelPriorityRun = cancelPriorityRun;
+    ItchReplayer replayer(engine, options);
+    
+    std::unique_ptr<PerfCounters> counters;
+    if (PerformanceBenchmark::hardwareCountersEnabled()) {
+        counters = std::make_unique<PerfCounters>();
+        counters->start();
+    }
+    ItchReplayStats stats = replayer.replay(reader);
+    if (counters) {
+        counters->stop();
+    }
+    
+    double elapsedMs = stats.elapsedNanoseconds / 1000000.0;
+    
+    std::cout << "\nFinal Order Book:" << std::endl;
+    std::cout << engine.getOrderBook().toString() << std::endl;
+    
+    std::cout << "Replay Statistics:" << std::endl;
+    std::cout << "  File Size:         " << reader.fileSize() << " bytes" << std::endl;
+    std::cout << "  Messages Replayed: " << stats.messages
+              << " (" << reader.skippedMessages() << " non-order messages skipped)" << std::endl;
+    std::cout << "  Adds:              " << stats.adds << std::endl;
+    std::cout << "  Executions:        " << stats.executions << std::endl;
+    std::cout << "  Partial Cancels:   " << stats.cancels << std::endl;
+    std::cout << "  Deletes:           " << stats.deletes << std::endl;
+    std::cout << "  Replaces:          " << stats.replaces << std::endl;
+    std::cout << "  Unknown Orders:    " << stats.unknownOrders << std::endl;
+    std::cout << "  Unrouted Messages: " << stats.unroutedMessages << std::endl;
+    std::cout << "  Trades:            " << stats.trades << std::endl;
+    std::cout << "  Decode Rate:       " << std::fixed << std::setprecision(2)
+              << decoded / decodeTimer.elapsedSeconds() << " msgs/sec" << std::endl;
+    std::cout << "  Elapsed Time:      " << std::fixed << std::setprecision(2) << elapsedMs << " ms" << std::endl;
+    std::cout << "  Throughput:        " << std::fixed << std::setprecision(2)
+              << stats.messages / (elapsedMs / 1000.0) << " msgs/sec" << std::endl;
+    if (counters) {
+        counters->printPerOperation(stats.messages);
+    }
+    
+    engine.stop();
+}
+
+// Result of one scaling benchmark configuration
+struct ScalingResult {
+    int producers;
+    size_t workers;
+    size_t books;
+    size_t orders;
+    double elapsedMs;
+    double throughput;
+    LatencySummary latencyUs;
+};
+
+// Run one producer/worker/book configuration and time it until the last order is processed
+ScalingResult runScalingConfiguration(int numProducers, size_t numWorkers, size_t numBooks, int ordersPerProducer) {
+    MatchingEngineConfig config;
+    config.numWorkers = numWorkers;
+    config.numBooks = numBooks;
+    config.logTrades = false;
+    MatchingEngine engine(config);
+    
+    // Pre-generate the order flow so order construction is not measured.
+    // IDs come from one contiguous range, so (id - firstId) indexes the per-order latency slots.
+    const size_t totalOrders = static_cast<size_t>(numProducers) * ordersPerProducer;
+    const Order::OrderId firstId = OrderIdGenerator::getInstance().reserveRange(totalOrders);
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(totalOrders);
+    for (size_t i = 0; i < totalOrders; ++i) {
+        orders.push_back(Order::createRandomOrderWithId(firstId + i, 90.0, 110.0, 1, 100, 0.2,
+                                                        static_cast<Order::InstrumentId>(i % numBooks)));
+    }
+    
+    std::vector<PerformanceTimer::TimePoint> submitTimes(totalOrders);
+    std::vector<double> latencies(totalOrders);
+    engine.registerOrderCallback([&](const Order& order) {
+        size_t slot = order.getId() - firstId;
+        latencies[slot] = std::chrono::duration<double, std::micro>(
+            PerformanceTimer::Clock::now() - submitTimes[slot]).count();
+    });
+    
+    // Opened before the workers start so their threads inherit the counters
+    std::unique_ptr<PerfCounters> counters;
+    if (PerformanceBenchmark::hardwareCountersEnabled()) {
+        counters = std::make_unique<PerfCounters>();
+    }
+    
+    engine.start();
+    
+    // Release all producers at once
+    std::atomic<bool> go{false};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            size_t begin = static_cast<size_t>(p) * ordersPerProducer;
+            for (size_t i = begin; i < begin + ordersPerProducer; ++i) {
+                submitTimes[i] = PerformanceTimer::Clock::now();
+                engine.submitOrder(orders[i]);
+            }
+        });
+    }
+    
+    PerformanceTimer timer;
+    if (counters) {
+        counters->start();
+    }
+    timer.start();
+    go.store(true, std::memory_order_release);
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    engine.waitForCompletion();
+    timer.stop();
+    if (counters) {
+        counters->stop();
+        counters->printPerOperation(totalOrders);
+    }
+    
+    engine.stop();
+    
+    ScalingResult result;
+    result.producers = numProducers;
+    result.workers = numWorkers;
+    result.books = numBooks;
+    result.orders = totalOrders;
+    result.elapsedMs = timer.elapsedMilliseconds();
+    result.throughput = totalOrders / timer.elapsedSeconds();
+    result.latencyUs = LatencySummary::fromSamples(latencies);
+    return result;
+}
+
+// Sweep producer, worker and book counts and write throughput and latency percentiles as CSV
+void runScalingBenchmark(int ordersPerRun, const std::string& csvPath) {
+    std::cout << "\n==== Scaling Benchmark ====" << std::endl;
+    std::cout << "Orders per configuration: " << ordersPerRun << std::endl;
+    
+    const std::vector<int> producerCounts = {1, 2, 4};
+    const std::vector<size_t> workerCounts = {1, 2, 4};
+    const std::vector<size_t> bookCounts = {1, 4, 16};
+    
+    std::ofstream csv(csvPath);
+    if (!csv) {
+        throw std::runtime_error("Cannot open " + csvPath + " for writing");
+    }
+    csv << "producers,workers,books,orders,elapsed_ms,throughput_ops,"
+        << "lat_mean_us,lat_p50_us,lat_p90_us,lat_p99_us,lat_p999_us,lat_max_us\n";
+    
+    for (int producers : producerCounts) {
+        for (size_t workers : workerCounts) {
+            for (size_t books : bookCounts) {
+                ScalingResult r = runScalingConfiguration(producers, workers, books, ordersPerRun / producers);
+                
+                csv << std::fixed << std::setprecision(3)
+                    << r.producers << "," << r.workers << "," << r.books << "," << r.orders << ","
+                    << r.elapsedMs << "," << r.throughput << ","
+                    << r.latencyUs.mean << "," << r.latencyUs.p50 << "," << r.latencyUs.p90 << ","
+                    << r.latencyUs.p99 << "," << r.latencyUs.p999 << "," << r.latencyUs.max << "\n";
+                
+                std::cout << std::fixed << std::setprecision(0)
+                          << "  producers=" << r.producers << " workers=" << r.workers << " books=" << r.books
+                          << "  throughput=" << r.throughput << " orders/sec"
+                          << std::setprecision(1)
+                          << "  p50=" << r.latencyUs.p50 << " μs"
+                          << "  p99=" << r.latencyUs.p99 << " μs" << std::endl;
+            }
+        }
+    }
+    
+    std::cout << "Results written to " << csvPath << std::endl;
+}
+
+// Open-loop load test that steps the send rate up until the engine saturates
+void runOpenLoopBenchmark(double startRate, double maxRate, double stepMs) {
+    std::cout << "\n==== Open-Loop Load Test ====" << std::endl;
+    
+    OpenLoopConfig config;
+    config.startRate = startRate;
+    config.maxRate = maxRate;
+    config.stepDurationSeconds = stepMs / 1000.0;
+    std::cout << "Stepping from " << std::fixed << std::setprecision(0) << startRate << " to " << maxRate
+              << " orders/sec, " << stepMs << " ms per step, saturated at p99 > "
+              << config.p99LimitUs << " μs" << std::endl;
+    
+    OpenLoopGenerator generator(config);
+    auto results = generator.findSaturation();
+    
+    std::cout << std::endl
+              << std::setw(12) << "target/s" << std::setw(12) << "achieved/s"
+              << std::setw(10) << "p50 μs" << std::setw(10) << "p99 μs" << std::setw(11) << "p99.9 μs"
+              << std::setw(12) << "max μs" << std::setw(14) << "send lag μs" << std::endl;
+    
+    const OpenLoopStepResult* knee = nullptr;
+    for (const auto& r : results) {
+        std::cout << std::fixed << std::setprecision(0)
+                  << std::setw(12) << r.targetRate << std::setw(12) << r.achievedRate
+                  << std::setprecision(1)
+                  << std::setw(10) << r.latencyUs.p50 << std::setw(10) << r.latencyUs.p99
+                  << std::setw(11) << r.latencyUs.p999 << std::setw(12) << r.latencyUs.max
+                  << std::setw(14) << r.maxSendLagUs
+                  << (r.saturated ? "  SATURATED" : "") << std::endl;
+        if (!r.saturated) {
+            knee = &r;
+        }
+    }
+    
+    if (knee) {
+        std::cout << "\nHighest sustainable rate: " << std::setprecision(0) << knee->targetRate
+                  << " orders/sec (p99 " << std::setprecision(1) << knee->latencyUs.p99 << " μs)" << std::endl;
+    } else {
+        std::cout << "\nSaturated at the starting rate; lower the start rate" << std::endl;
+    }
+}
+
+// Load books of increasing size and report what a resting order costs
+void runMemoryBenchmark(const std::vector<size_t>& bookSizes, bool useArenas) {
+    std::cout << "\n==== Memory Footprint Benchmark ====" << std::endl;
+    std::cout << "Book containers allocate from " << (useArenas ? "per-book arenas" : "the global heap") << std::endl;
+    
+    const double mb = 1024.0 * 1024.0;
+    for (size_t numOrders : bookSizes) {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        config.useArenas = useArenas;
+        MatchingEngine engine(config);
+        
+        size_t rssBefore = currentRssBytes();
+        
+        // Non-crossing book: bids below 100.00 and asks from 100.00 up, 1000 levels per side
+        for (size_t i = 0; i < numOrders; ++i) {
+            bool buy = i % 2 == 0;
+            double offset = static_cast<double>((i / 2) % 1000);
+            double price = buy ? (9999.0 - offset) / 100.0 : (10000.0 + offset) / 100.0;
+            engine.processOrderSync(Order::createOrder(
+                buy ? OrderSide::BUY : OrderSide::SELL, OrderType::LIMIT, price, 100));
+        }
+        
+        size_t rssAfter = currentRssBytes();
+        MemoryUsage usage = engine.getMemoryUsage();
+        
+        std::cout << "\nResting orders:      " << usage.restingOrders << std::endl;
+        std::cout << "Price levels:        " << usage.priceLevels << std::endl;
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  Orders:            " << usage.orderBytes / mb << " MB" << std::endl
+                  << "  Priority tree:     " << usage.priorityTreeBytes / mb << " MB" << std::endl
+                  << "  Index:             " << usage.indexBytes / mb << " MB" << std::endl
+                  << "  Queue:             " << usage.queueBytes / mb << " MB" << std::endl
+                  << "  Buffers:           " << usage.bufferBytes / mb << " MB" << std::endl
+                  << "  Total accounted:   " << usage.totalBytes() / mb << " MB" << std::endl
+                  << "  Arena reserved:    " << usage.arenaBytes / mb << " MB" << std::endl
+                  << "  Bytes/order:       " << usage.bytesPerRestingOrder() << std::endl;
+        if (rssAfter > 0) {
+            std::cout << "  RSS:               " << rssAfter / mb << " MB" << std::endl
+                      << "  RSS bytes/order:   "
+                      << static_cast<double>(rssAfter - std::min(rssBefore, rssAfter)) / numOrders << std::endl;
+        }
+    }
+}
+
+// Random order lookups over a large book with and without huge-page backed arenas
+void runHugePageBenchmark(size_t numOrders, size_t numLookups) {
+    std::cout << "\n==== Huge Page Benchmark ====" << std::endl;
+    std::cout << "Resting orders: " << numOrders << ", random lookups: " << numLookups << std::endl;
+    
+    const double mb = 1024.0 * 1024.0;
+    const std::pair<HugePageMode, const char*> modes[] = {
+        {HugePageMode::NONE, "normal pages"},
+        {HugePageMode::TRANSPARENT, "transparent huge pages"},
+        {HugePageMode::EXPLICIT, "hugetlbfs pages"},
+    };
+    
+    for (const auto& [mode, name] : modes) {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        config.hugePages = mode;
+        MatchingEngine engine(config);
+        
+        std::vector<Order::OrderId> ids;
+        ids.reserve(numOrders);
+        for (size_t i = 0; i < numOrders; ++i) {
+            bool buy = i % 2 == 0;
+            double offset = static_cast<double>((i / 2) % 1000);
+            double price = buy ? (9999.0 - offset) / 100.0 : (10000.0 + offset) / 100.0;
+            auto order = Order::createOrder(buy ? OrderSide::BUY : OrderSide::SELL, OrderType::LIMIT, price, 100);
+            ids.push_back(order->getId());
+            engine.processOrderSync(order);
+        }
+        
+        // Pre-draw the lookup sequence so the RNG is not measured
+        std::mt19937_64 gen(42);
+        std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+        std::vector<Order::OrderId> lookups(numLookups);
+        for (auto& id : lookups) {
+            id = ids[pick(gen)];
+        }
+        
+        const OrderBook& book = engine.getOrderBook();
+        PerfCounters counters;
+        PerformanceTimer timer;
+        size_t found = 0;
+        counters.start();
+        timer.start();
+        for (Order::OrderId id : lookups) {
+            found += book.findOrder(id) != nullptr;
+        }
+        timer.stop();
+        counters.stop();
+        
+        MemoryUsage usage = engine.getMemoryUsage();
+        std::cout << "\n" << name << ":" << std::endl;
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  Huge-page regions:  " << usage.hugePageBytes / mb << " MB mapped ("
+                  << usage.arenaBytes / mb << " MB used by arenas)" << std::endl
+                  << "  Process THP:        " << currentAnonHugePageBytes() / mb << " MB" << std::endl
+                  << "  Lookup time:        " << static_cast<double>(timer.elapsedNanoseconds()) / numLookups
+                  << " ns (" << found << " found)" << std::endl;
+        if (counters.available(PerfEvent::DTLB_MISSES)) {
+            std::cout << "  dTLB misses/lookup: " << std::setprecision(3)
+                      << static_cast<double>(counters.value(PerfEvent::DTLB_MISSES)) / numLookups << std::endl;
+        } else {
+            std::cout << "  dTLB misses/lookup: n/a (hardware counters unavailable)" << std::endl;
+        }
+    }
+}
+
+// Latency of the first orders after start, with and without the warm-up phase
+void runWarmUpBenchmark(size_t numOrders, HugePageMode hugePages) {
+    std::cout << "\n==== Warm-Up Benchmark ====" << std::endl;
+    std::cout << "Measuring the first " << numOrders << " orders after start" << std::endl;
+    
+    // The cold run goes first so it does not benefit from the warm run's caches
+    for (bool warmUp : {false, true}) {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        config.hugePages = hugePages;
+        config.warmUp = warmUp;
+        MatchingEngine engine(config);
+        
+        std::vector<std::shared_ptr<Order>> orders;
+        orders.reserve(numOrders);
+        for (size_t i = 0; i < numOrders; ++i) {
+            orders.push_back(Order::createRandomOrder());
+        }
+        
+        PerformanceTimer startTimer;
+        startTimer.start();
+        engine.start();
+        startTimer.stop();
+        
+        std::vector<double> latencies;
+        latencies.reserve(numOrders);
+        for (const auto& order : orders) {
+            PerformanceTimer timer;
+            timer.start();
+            engine.processOrderSync(order);
+            timer.stop();
+            latencies.push_back(timer.elapsedNanoseconds() / 1000.0);
+        }
+        engine.stop();
+        
+        auto summarize = [&latencies](size_t begin, size_t end) {
+            std::vector<double> window(latencies.begin() + begin, latencies.begin() + end);
+            return LatencySummary::fromSamples(window);
+        };
+        
+        std::cout << "\n" << (warmUp ? "With warm-up" : "Cold start") << " (start took "
+                  << std::fixed << std::setprecision(1) << startTimer.elapsedMilliseconds() << " ms):" << std::endl;
+        const size_t windows[] = {100, 1000, numOrders};
+        size_t begin = 0;
+        for (size_t end : windows) {
+            end = std::min(end, numOrders);
+            if (end <= begin) {
+                continue;
+            }
+            LatencySummary s = summarize(begin, end);
+            std::cout << "  Orders " << std::setw(6) << begin + 1 << "-" << std::left << std::setw(8) << end
+                      << std::right << std::setprecision(2)
+                      << " mean=" << s.mean << " μs  p50=" << s.p50 << " μs  p99=" << s.p99
+                      << " μs  max=" << s.max << " μs" << std::endl;
+            begin = end;
+        }
+    }
+}
+
+// Run a single benchmark selected on the command line
+// Formatting cost of trades and throughput of the bulk trade exporter
+void runExportBenchmark(size_t numTrades, TradeExportFormat format, const std::string& path) {
+    std::cout << "\n==== Trade Export Benchmark ====" << std::endl;
+    std::cout << "Exporting " << numTrades << " trades as "
+              << (format == TradeExportFormat::CSV ? "CSV" : "JSON lines") << " to " << path << std::endl;
+    
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<Order::PriceTicks> priceDist(Order::toTicks(90.0), Order::toTicks(110.0));
+    std::uniform_int_distribution<Order::Quantity> qtyDist(1, 100);
+    std::vector<Trade> trades;
+    trades.reserve(numTrades);
+    for (size_t i = 0; i < numTrades; ++i) {
+        trades.emplace_back(static_cast<Trade::TradeId>(i + 1), 2 * i + 1, 2 * i + 2, priceDist(gen), qtyDist(gen),
+                            static_cast<Order::InstrumentId>(i % 16), i % 2 == 0 ? OrderSide::BUY : OrderSide::SELL);
+    }
+    
+    // Per-trade formatting: toString allocates the result, formatTo does not
+    size_t checksum = 0;
+    PerformanceTimer stringTimer;
+    stringTimer.start();
+    for (const auto& trade : trades) {
+        checksum += trade.toString().size();
+    }
+    stringTimer.stop();
+    
+    char buffer[Trade::kMaxFormattedLength];
+    PerformanceTimer formatTimer;
+    formatTimer.start();
+    for (const auto& trade : trades) {
+        checksum += trade.formatTo(buffer, sizeof(buffer));
+    }
+    formatTimer.stop();
+    
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    PerformanceTimer exportTimer;
+    exportTimer.start();
+    TradeExporter exporter(out, format);
+    exporter.write(trades);
+    exporter.flush();
+    out.flush();
+    exportTimer.stop();
+    
+    const double tradeCount = static_cast<double>(numTrades);
+    double exportSeconds = exportTimer.elapsedNanoseconds() / 1e9;
+    std::cout << std::fixed << std::setprecision(1)
+              << "  Trade::toString:  " << stringTimer.elapsedNanoseconds() / tradeCount << " ns/trade" << std::endl
+              << "  Trade::formatTo:  " << formatTimer.elapsedNanoseconds() / tradeCount << " ns/trade" << std::endl
+              << "  TradeExporter:    " << exportTimer.elapsedNanoseconds() / tradeCount << " ns/trade, "
+              << exporter.bytesWritten() / exportSeconds / (1024.0 * 1024.0) << " MB/s ("
+              << exporter.bytesWritten() << " bytes)" << std::endl;
+    
+    // Keep the formatting loops from being optimized away
+    if (checksum == 0) {
+        std::cout << "  (no output)" << std::endl;
+    }
+}
+
+// Fan-out of engine events to a fast and a slow subscriber
+void runFanOutBenchmark(size_t numOrders, LagPolicy slowPolicy) {
+    const char* policyNames[] = {"block", "conflate", "disconnect"};
+    std::cout << "\n==== Fan-Out Benchmark ====" << std::endl;
+    std::cout << "Processing " << numOrders << " orders; the slow subscriber uses the "
+              << policyNames[static_cast<int>(slowPolicy)] << " policy" << std::endl;
+    
+    MatchingEngineConfig config;
+    config.logTrades = false;
+    config.fanOutCapacity = 4096;
+    MatchingEngine engine(config);
+    
+    std::atomic<uint64_t> marketDataTrades{0};
+    engine.addEventSubscriber("market-data", LagPolicy::BLOCK, [&marketDataTrades](const EngineEvent& event) {
+        if (event.type == EngineEventType::TRADE) {
+            marketDataTrades.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    // Stands in for a risk system that needs about 5 μs per event
+    engine.addEventSubscriber("risk", slowPolicy, [](const EngineEvent&) {
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(5);
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    });
+    
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(numOrders);
+    for (size_t i = 0; i < numOrders; ++i) {
+        orders.push_back(Order::createRandomOrder());
+    }
+    
+    engine.start();
+    PerformanceTimer timer;
+    timer.start();
+    for (const auto& order : orders) {
+        engine.submitOrder(order);
+    }
+    engine.waitForCompletion();
+    timer.stop();
+    
+    auto printStats = [&policyNames](const std::vector<FanOutSubscriberStats>& stats) {
+        for (const auto& s : stats) {
+            std::cout << "  " << std::left << std::setw(12) << s.name << std::right
+                      << " policy=" << std::setw(10) << policyNames[static_cast<int>(s.policy)]
+                      << " delivered=" << std::setw(8) << s.delivered
+                      << " skipped=" << std::setw(8) << s.skipped
+                      << " lag=" << std::setw(6) << s.lag
+                      << " maxLag=" << std::setw(6) << s.maxLag
+                      << (s.disconnected ? "  DISCONNECTED" : "") << std::endl;
+        }
+    };
+    
+    std::cout << std::fixed << std::setprecision(0)
+              << "Engine throughput: " << numOrders / (timer.elapsedMilliseconds() / 1000.0) << " orders/sec" << std::endl;
+    std::cout << "When the last order was processed:" << std::endl;
+    printStats(engine.getEventSubscriberStats());
+    
+    engine.stop();
+    std::cout << "After stop:" << std::endl;
+    printStats(engine.getEventSubscriberStats());
+    std::cout << "Trades seen by market-data: " << marketDataTrades.load() << std::endl;
+}
+
+// Worker pool versus the staged risk/journal/match/publish pipeline
+void runPipelineBenchmark(size_t numOrders, const std::string& journalPath) {
+    std::cout << "\n==== Pipeline Benchmark ====" << std::endl;
+    std::cout << "Submitting " << numOrders << " orders from one producer"
+              << (journalPath.empty() ? "" : ", journaling to " + journalPath) << std::endl;
+    
+    for (bool pipeline : {false, true}) {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        config.pipeline = pipeline;
+        config.journalPath = pipeline ? journalPath : "";
+        MatchingEngine engine(config);
+        
+        std::vector<std::shared_ptr<Order>> orders;
+        orders.reserve(numOrders);
+        for (size_t i = 0; i < numOrders; ++i) {
+            orders.push_back(Order::createRandomOrder());
+        }
+        
+        engine.start();
+        PerformanceTimer timer;
+        timer.start();
+        for (const auto& order : orders) {
+            engine.submitOrder(order);
+        }
+        engine.waitForCompletion();
+        timer.stop();
+        
+        std::cout << "\n" << (pipeline ? "Pipeline" : "Worker pool (1 worker)") << ":" << std::endl;
+        std::cout << std::fixed << std::setprecision(0)
+                  << "  Throughput: " << numOrders / (timer.elapsedMilliseconds() / 1000.0) << " orders/sec, "
+                  << engine.getStats().totalTradesExecuted.load() << " trades" << std::endl;
+        for (const auto& stage : engine.getPipelineStats()) {
+            std::cout << "  " << std::left << std::setw(8) << stage.name << std::right
+                      << " processed=" << stage.processed << " batches=" << stage.batches
+                      << std::setprecision(1) << " avg batch="
+                      << (stage.batches ? static_cast<double>(stage.processed) / stage.batches : 0.0) << std::endl;
+        }
+        engine.stop();
+        if (const OrderJournal* journal = engine.getOrderJournal()) {
+            std::cout << "  Journal: " << journal->recordsWritten() << " records written, "
+                      << journal->recordsLost() << " lost" << std::endl;
+        }
+    }
+}
+
+void printRiskRejects(const RiskEngine& risk) {
+    for (size_t i = 1; i < static_cast<size_t>(RiskRejectReason::COUNT); ++i) {
+        auto reason = static_cast<RiskRejectReason>(i);
+        if (risk.rejectedOrders(reason) > 0) {
+            std::cout << "    " << std::left << std::setw(16) << toString(reason) << std::right
+                      << risk.rejectedOrders(reason) << std::endl;
+        }
+    }
+}
+
+void printValidationRejects(const OrderValidator& validator) {
+    for (size_t i = 1; i < static_cast<size_t>(ValidationRejectReason::COUNT); ++i) {
+        auto reason = static_cast<ValidationRejectReason>(i);
+        if (validator.rejectedOrders(reason) > 0) {
+            std::cout << "    " << std::left << std::setw(20) << toString(reason) << std::right
+                      << validator.rejectedOrders(reason) << std::endl;
+        }
+    }
+}
+
+// Straightforward validation with divisions, to check the table-driven one against
+ValidationRejectReason validateWithDivisions(const std::vector<InstrumentSpec>& specs, const Order& order) {
+    if (order.getInstrument() >= specs.size()) return ValidationRejectReason::UNKNOWN_INSTRUMENT;
+    const InstrumentSpec& spec = specs[order.getInstrument()];
+    bool limit = order.getType() == OrderType::LIMIT;
+    const double maxTicks = std::numeric_limits<Order::PriceTicks>::max();
+    if (limit && !(order.getPrice() > 0 && order.getPrice() * Order::kTicksPerUnit <= maxTicks)) {
+        return ValidationRejectReason::INVALID_PRICE;
+    }
+    if (order.getQuantity() < spec.minQuantity || order.getQuantity() > spec.maxQuantity) return ValidationRejectReason::QUANTITY_RANGE;
+    if (order.getQuantity() % spec.lotSize != 0) return ValidationRejectReason::LOT_SIZE;
+    if (limit && Order::toTicks(order.getPrice()) % Order::toTicks(spec.tickSize) != 0) return ValidationRejectReason::TICK_SIZE;
+    if (limit && (order.getPrice() < spec.minPrice || order.getPrice() > spec.maxPrice)) return ValidationRejectReason::PRICE_RANGE;
+    return ValidationRejectReason::NONE;
+}
+
+void runValidationBenchmark(size_t numOrders) {
+    std::cout << "\n==== Order Validation Benchmark ====" << std::endl;
+    
+    // Four instruments with different tick and lot sizes
+    std::vector<InstrumentSpec> specs(4);
+    specs[0].tickSize = 0.01;
+    specs[0].maxQuantity = 10000;
+    specs[0].minPrice = 1.0;
+    specs[0].maxPrice = 1000.0;
+    specs[1].tickSize = 0.05;
+    specs[1].lotSize = 100;
+    specs[1].minQuantity = 100;
+    specs[1].maxQuantity = 100000;
+    specs[1].minPrice = 10.0;
+    specs[1].maxPrice = 500.0;
+    specs[2].tickSize = 0.0025;
+    specs[2].lotSize = 10;
+    specs[2].minQuantity = 10;
+    specs[2].maxPrice = 200.0;
+    specs[3].tickSize = 0.5;
+    specs[3].lotSize = 5;
+    specs[3].minQuantity = 5;
+    specs[3].maxQuantity = 5000;
+    specs[3].minPrice = 50.0;
+    specs[3].maxPrice = 150.0;
+    
+    // Mostly valid orders, one in ten broken in one of several ways
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<Order::InstrumentId> instrumentDist(0, 3);
+    std::uniform_int_distribution<int> stepDist(200, 2000);
+    std::uniform_int_distribution<Order::Quantity> lotsDist(1, 20);
+    std::uniform_int_distribution<int> faultDist(0, 59);
+    std::bernoulli_distribution marketDist(0.1);
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(numOrders);
+    for (size_t i = 0; i < numOrders; ++i) {
+        Order::InstrumentId instrument = instrumentDist(gen);
+        const InstrumentSpec& spec = specs[instrument];
+        double price = stepDist(gen) * spec.tickSize;
+        Order::Quantity quantity = lotsDist(gen) * spec.lotSize;
+        while (price < spec.minPrice) price *= 2;
+        while (price > spec.maxPrice) price /= 2;
+        price = std::round(price / spec.tickSize) * spec.tickSize;
+        switch (faultDist(gen)) {
+            case 0: quantity = 0; break;
+            case 1: price = -price; break;
+            case 2: price += 0.0001; break;
+            case 3: quantity += 1; break;
+            case 4: price = spec.maxPrice + 10 * spec.tickSize; break;
+            case 5: quantity = spec.maxQuantity + spec.lotSize; break;
+            default: break;
+        }
+        OrderType type = marketDist(gen) ? OrderType::MARKET : OrderType::LIMIT;
+        orders.push_back(std::make_shared<Order>(i + 1, i % 2 ? OrderSide::BUY : OrderSide::SELL, type,
+                                                 type == OrderType::MARKET ? 0.0 : price, quantity, instrument));
+    }
+    
+    // Both validators over the same orders, laid out contiguously; the results must agree
+    std::vector<Order> flat;
+    flat.reserve(numOrders);
+    for (const auto& order : orders) {
+        flat.push_back(*order);
+    }
+    OrderValidator validator(specs);
+    std::vector<ValidationRejectReason> fast(numOrders), reference(numOrders);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < numOrders; ++i) {
+        fast[i] = validator.validate(flat[i]);
+        reference[i] = validateWithDivisions(specs, flat[i]);
+        mismatches += fast[i] != reference[i];
+    }
+    
+    // Timed over a cache-resident slice, so the cost of the checks is not hidden behind memory traffic
+    const size_t hotOrders = std::min<size_t>(numOrders, 4096);
+    const size_t passes = std::max<size_t>(1, numOrders / hotOrders);
+    OrderValidator timedValidator(specs);
+    PerformanceTimer timer;
+    timer.start();
+    for (size_t pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < hotOrders; ++i) {
+            fast[i] = timedValidator.validate(flat[i]);
+        }
+    }
+    timer.stop();
+    double fastNs = timer.elapsedNanoseconds() / static_cast<double>(passes * hotOrders);
+    timer.start();
+    for (size_t pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < hotOrders; ++i) {
+            reference[i] = validateWithDivisions(specs, flat[i]);
+        }
+    }
+    timer.stop();
+    double referenceNs = timer.elapsedNanoseconds() / static_cast<double>(passes * hotOrders);
+    
+    std::cout << numOrders << " orders over 4 instruments" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "  Table-driven: " << fastNs << " ns per order" << std::endl
+              << "  With divisions: " << referenceNs << " ns per order" << std::endl
+              << "  Results differing: " << mismatches << std::endl;
+    printValidationRejects(validator);
+    
+    // End to end: invalid orders are rejected on the submitting thread and never queued
+    MatchingEngineConfig config;
+    config.logTrades = false;
+    config.numBooks = specs.size();
+    config.instruments = specs;
+    MatchingEngine engine(config);
+    engine.start();
+    size_t accepted = 0;
+    timer.start();
+    for (const auto& order : orders) {
+        accepted += engine.submitOrder(std::make_shared<Order>(order->getId(), order->getSide(), order->getType(),
+                                                               order->getPrice(), order->getQuantity(),
+                                                               order->getInstrument()));
+    }
+    engine.waitForCompletion();
+    timer.stop();
+    std::cout << "\nEngine:" << std::endl;
+    std::cout << std::fixed << std::setprecision(0)
+              << "  Throughput: " << numOrders / (timer.elapsedMilliseconds() / 1000.0) << " orders/sec, "
+              << accepted << " accepted, " << engine.getStats().totalOrdersProcessed.load() << " processed, "
+              << engine.getStats().totalTradesExecuted.load() << " trades" << std::endl;
+    engine.stop();
+}
+
+void runTickTableBenchmark(size_t numConversions) {
+    std::cout << "\n==== Tick Table Benchmark ====" << std::endl;
+    
+    // Finer ticks at lower prices; every boundary is on the grid of the band below
+    std::vector<TickBand> bands = {{0.01, 0.01}, {1.00, 0.05}, {10.00, 0.10}, {100.00, 0.50}, {1000.00, 5.00}};
+    TickTable table(bands);
+    std::cout << "Bands:" << std::endl;
+    for (const TickBand& band : table.getBands()) {
+        Order::PriceTicks start = Order::toTicks(band.from);
+        std::cout << std::fixed << std::setprecision(2) << "  from " << std::setw(8) << band.from
+                  << " tick " << std::setw(5) << band.tickSize << "  first level " << table.levelOf(start) << std::endl;
+    }
+    std::cout << "Prices around the 1.00 boundary:" << std::endl;
+    for (double price : {0.98, 0.99, 1.00, 1.03, 1.05, 1.10}) {
+        Order::PriceTicks ticks = Order::toTicks(price);
+        std::cout << "  " << price << (table.isValid(ticks) ? " -> level " + std::to_string(table.levelOf(ticks))
+                                                            : std::string(" -> off the grid")) << std::endl;
+    }
+    
+    // Every valid price up to 5000.00, for a binary-search baseline and the random sample
+    std::vector<Order::PriceTicks> grid;
+    for (Order::PriceTicks price = Order::toTicks(0.01); price <= Order::toTicks(5000.00);
+         price += table.tickAt(price)) {
+        grid.push_back(price);
+    }
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<size_t> indexDist(0, grid.size() - 1);
+    std::vector<Order::PriceTicks> prices(numConversions);
+    for (auto& price : prices) {
+        price = grid[indexDist(gen)];
+    }
+    
+    std::vector<TickTable::Level> levels(numConversions);
+    PerformanceTimer timer;
+    timer.start();
+    for (size_t i = 0; i < numConversions; ++i) {
+        levels[i] = table.levelOf(prices[i]);
+    }
+    timer.stop();
+    double tableNs = timer.elapsedNanoseconds() / static_cast<double>(numConversions);
+    
+    std::vector<TickTable::Level> searched(numConversions);
+    timer.start();
+    for (size_t i = 0; i < numConversions; ++i) {
+        searched[i] = static_cast<TickTable::Level>(std::lower_bound(grid.begin(), grid.end(), prices[i]) - grid.begin());
+    }
+    timer.stop();
+    double searchNs = timer.elapsedNanoseconds() / static_cast<double>(numConversions);
+    
+    size_t mismatches = 0;
+    for (size_t i = 0; i < numConversions; ++i) {
+        mismatches += levels[i] != searched[i] || table.priceOf(levels[i]) != prices[i];
+    }
+    std::cout << "\n" << numConversions << " price-to-level conversions over " << grid.size() << " levels:" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "  Tick table:    " << tableNs << " ns per conversion" << std::endl
+              << "  Binary search: " << searchNs << " ns per conversion" << std::endl
+              << "  Levels or round trips differing: " << mismatches << std::endl;
+    
+    // The engine validates against the bands and measures spreads on the same grid
+    MatchingEngineConfig config;
+    config.logTrades = false;
+    config.instruments.resize(1);
+    config.instruments[0].tickBands = bands;
+    MatchingEngine engine(config);
+    engine.start();
+    std::cout << "\nEngine with the table:" << std::endl;
+    for (double price : {0.98, 1.05, 1.07, 12.34, 12.30}) {
+        OrderSide side = price < 1.0 ? OrderSide::BUY : OrderSide::SELL;
+        auto order = Order::createOrder(side, OrderType::LIMIT, price, 10);
+        engine.processOrderSync(order);
+        std::cout << "  " << (side == OrderSide::BUY ? "Buy " : "Sell ") << std::setprecision(2) << price << ": "
+                  << (order->getStatus() == OrderStatus::REJECTED ? "rejected" : "accepted") << std::endl;
+    }
+    std::cout << "  Spread 0.98 / 1.05: " << engine.getOrderBook().getSpreadLevels() << " levels" << std::endl;
+    printValidationRejects(engine.getValidator());
+    engine.stop();
+}
+
+void runRiskBenchmark(size_t numOrders, size_t numAccounts) {
+    std::cout << "\n==== Pre-trade Risk Benchmark ====" << std::endl;
+    std::cout << numOrders << " random orders over " << numAccounts << " accounts" << std::endl;
+    
+    RiskLimits limits;
+    limits.maxOrderQuantity = 90;
+    limits.maxOrderNotional = 9000.0;
+    limits.maxOpenNotional = 100000.0;
+    limits.maxPosition = 1000;
+    limits.priceBand = 0.08;
+    
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<Order::AccountId> accountDist(0, static_cast<Order::AccountId>(numAccounts - 1));
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(numOrders);
+    for (size_t i = 0; i < numOrders; ++i) {
+        orders.push_back(Order::createRandomOrder(90.0, 110.0, 1, 100, 0.2, 0, accountDist(gen)));
+    }
+    
+    // Cost of the check alone: accepted orders are canceled right away so the limits stay reachable
+    {
+        RiskEngine risk(numAccounts, 1, limits);
+        PerformanceTimer timer;
+        timer.start();
+        for (const auto& order : orders) {
+            if (risk.check(*order) == RiskRejectReason::NONE) {
+                risk.onOrderRemoved(*order, order->getQuantity());
+            }
+        }
+        timer.stop();
+        std::cout << "\nCheck only:" << std::endl;
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  Cost: " << timer.elapsedNanoseconds() / static_cast<double>(numOrders)
+                  << " ns per order (check + release)" << std::endl;
+        printRiskRejects(risk);
+    }
+    
+    // End to end: the checks run on the submitting thread in front of the queue
+    for (bool riskChecks : {false, true}) {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        config.riskChecks = riskChecks;
+        config.numAccounts = numAccounts;
+        config.riskLimits = limits;
+        MatchingEngine engine(config);
+        
+        // Fresh copies, since the first pass filled or rejected the originals
+        std::vector<std::shared_ptr<Order>> copies;
+        copies.reserve(numOrders);
+        for (const auto& order : orders) {
+            copies.push_back(std::make_shared<Order>(order->getId(), order->getSide(), order->getType(),
+                                                     order->getPrice(), order->getQuantity(),
+                                                     order->getInstrument(), order->getAccount()));
+        }
+        
+        engine.start();
+        size_t accepted = 0;
+        PerformanceTimer timer;
+        timer.start();
+        for (const auto& order : copies) {
+            accepted += engine.submitOrder(order);
+        }
+        engine.waitForCompletion();
+        timer.stop();
+        
+        std::cout << "\n" << (riskChecks ? "Engine with risk checks" : "Engine without risk checks") << ":" << std::endl;
+        std::cout << std::fixed << std::setprecision(0)
+                  << "  Throughput: " << numOrders / (timer.elapsedMilliseconds() / 1000.0) << " orders/sec, "
+                  << accepted << " accepted, " << engine.getStats().totalTradesExecuted.load() << " trades"
+                  << std::endl;
+        if (const RiskEngine* risk = engine.getRiskEngine()) {
+            printRiskRejects(*risk);
+        }
+        engine.stop();
+    }
+}
+
+void runPositionBenchmark(size_t numOrders, size_t numAccounts) {
+    constexpr size_t kInstruments = 4;
+    std::cout << "\n==== Position Keeping Benchmark ====" << std::endl;
+    std::cout << numOrders << " random orders over " << numAccounts << " accounts and "
+              << kInstruments << " instruments" << std::endl;
+    
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<Order::AccountId> accountDist(0, static_cast<Order::AccountId>(numAccounts - 1));
+    std::uniform_int_distribution<Order::InstrumentId> instrumentDist(0, kInstruments - 1);
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(numOrders);
+    for (size_t i = 0; i < numOrders; ++i) {
+        orders.push_back(Order::createRandomOrder(90.0, 110.0, 1, 100, 0.2, instrumentDist(gen), accountDist(gen)));
+    }
+    
+    for (bool trackPositions : {false, true}) {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        config.numBooks = kInstruments;
+        config.numAccounts = numAccounts;
+        config.trackPositions = trackPositions;
+        MatchingEngine engine(config);
+        
+        std::vector<std::shared_ptr<Order>> copies;
+        copies.reserve(numOrders);
+        for (const auto& order : orders) {
+            copies.push_back(std::make_shared<Order>(order->getId(), order->getSide(), order->getType(),
+                                                     order->getPrice(), order->getQuantity(),
+                                                     order->getInstrument(), order->getAccount()));
+        }
+        
+        // A reader takes snapshots the whole time to show they do not stop the updates
+        std::atomic<bool> reading{trackPositions};
+        std::atomic<uint64_t> snapshots{0};
+        std::thread reader;
+        if (const PositionKeeper* keeper = engine.getPositionKeeper()) {
+            reader = std::thread([keeper, &reading, &snapshots, numAccounts] {
+                std::mt19937 readerGen(11);
+                while (reading.load(std::memory_order_relaxed)) {
+                    keeper->getAccountPositions(static_cast<Order::AccountId>(readerGen() % numAccounts));
+                    snapshots.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        
+        engine.start();
+        PerformanceTimer timer;
+        timer.start();
+        for (const auto& order : copies) {
+            engine.submitOrder(order);
+        }
+        engine.waitForCompletion();
+        timer.stop();
+        engine.stop();
+        reading = false;
+        if (reader.joinable()) {
+            reader.join();
+        }
+        
+        std::cout << "\n" << (trackPositions ? "With position keeping" : "Without position keeping") << ":" << std::endl;
+        std::cout << std::fixed << std::setprecision(0)
+                  << "  Throughput: " << numOrders / (timer.elapsedMilliseconds() / 1000.0) << " orders/sec, "
+                  << engine.getStats().totalTradesExecuted.load() << " trades" << std::endl;
+        
+        const PositionKeeper* keeper = engine.getPositionKeeper();
+        if (!keeper) {
+            continue;
+        }
+        std::cout << "  Fills applied: " << keeper->appliedFills() << ", snapshots read while running: "
+                  << snapshots.load() << " (" << keeper->snapshotRetries() << " retries)" << std::endl;
+        
+        // Every fill has a buyer and a seller, so positions and P&L sum to zero over the accounts
+        std::vector<PositionSnapshot> all;
+        for (size_t account = 0; account < numAccounts; ++account) {
+            auto positions = keeper->getAccountPositions(static_cast<Order::AccountId>(account));
+            all.insert(all.end(), positions.begin(), positions.end());
+        }
+        int64_t netPosition = 0;
+        double totalPnl = 0.0;
+        for (const auto& p : all) {
+            netPosition += p.netPosition;
+            totalPnl += p.realizedPnl + p.unrealizedPnl;
+        }
+        std::cout << std::setprecision(2) << "  Sum of net positions: " << netPosition
+                  << ", sum of P&L: " << totalPnl << std::endl;
+        
+        std::sort(all.begin(), all.end(), [](const PositionSnapshot& a, const PositionSnapshot& b) {
+            return std::abs(a.realizedPnl + a.unrealizedPnl) > std::abs(b.realizedPnl + b.unrealizedPnl);
+        });
+        std::cout << "  Largest P&L:" << std::endl;
+        for (size_t i = 0; i < std::min<size_t>(5, all.size()); ++i) {
+            const auto& p = all[i];
+            std::cout << "    account " << std::setw(4) << p.account << " instrument " << p.instrument
+                      << ": position " << std::setw(5) << p.netPosition << " avg " << std::setw(7) << p.averagePrice
+                      << " realized " << std::setw(9) << p.realizedPnl << " unrealized " << std::setw(9)
+                      << p.unrealizedPnl << " volume " << p.volume << std::endl;
+        }
+    }
+}
+
+void runNettingBenchmark(size_t numTrades, size_t maxThreads, const std::string& path) {
+    constexpr Order::AccountId kAccounts = 200;
+    constexpr Order::InstrumentId kInstruments = 64;
+    std::cout << "\n==== End-of-Day Netting Benchmark ====" << std::endl;
+    
+    // The engine writes the same file when MatchingEngineConfig::tradeStorePath is set
+    {
+        std::mt19937 gen(2024);
+        std::uniform_int_distribution<Order::AccountId> accountDist(0, kAccounts - 1);
+        std::uniform_int_distribution<Order::InstrumentId> instrumentDist(0, kInstruments - 1);
+        std::uniform_int_distribution<Order::PriceTicks> priceDist(Order::toTicks(90.0), Order::toTicks(110.0));
+        std::uniform_int_distribution<Order::Quantity> qtyDist(1, 100);
+        TradeStoreWriter writer(path);
+        Order::TimeStamp start = std::chrono::system_clock::now();
+        for (size_t i = 0; i < numTrades; ++i) {
+            Trade trade(static_cast<Trade::TradeId>(i + 1), 2 * i + 1, 2 * i + 2, priceDist(gen), qtyDist(gen),
+                        instrumentDist(gen), i % 2 ? OrderSide::BUY : OrderSide::SELL);
+            writer.append(Fill{trade, accountDist(gen), accountDist(gen), start + std::chrono::microseconds(i)});
+        }
+        if (!writer.close()) {
+            throw std::runtime_error("Cannot write trade store file " + path + ": " +
+                                     std::to_string(writer.recordsLost()) + " trades lost");
+        }
+    }
+    
+    TradeStoreReader store(path);
+    std::cout << "Trade store " << path << ": " << store.size() << " trades, "
+              << store.fileSize() / (1024 * 1024) << " MB, " << kAccounts << " accounts, "
+              << kInstruments << " instruments" << std::endl;
+    
+    std::vector<NetObligation> reference;
+    double singleThreadMs = 0.0;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        NettingBatch batch(threads);
+        std::vector<NetObligation> obligations = batch.run(store.records(), store.size());
+        const NettingStats& stats = batch.getStats();
+        
+        bool matches = true;
+        if (reference.empty()) {
+            reference = obligations;
+            singleThreadMs = stats.elapsedMilliseconds;
+        } else {
+            matches = obligations.size() == reference.size() &&
+                std::equal(obligations.begin(), obligations.end(), reference.begin(),
+                           [](const NetObligation& a, const NetObligation& b) {
+                               return a.instrument == b.instrument && a.firstAccount == b.firstAccount &&
+                                      a.secondAccount == b.secondAccount && a.netQuantity == b.netQuantity &&
+                                      a.netCash == b.netCash && a.trades == b.trades;
+                           });
+        }
+        
+        double tradesPerSecond = stats.trades / (stats.elapsedMilliseconds / 1000.0);
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  " << std::setw(2) << threads << " threads: " << std::setw(8) << stats.elapsedMilliseconds
+                  << " ms, " << std::setprecision(0) << std::setw(11) << tradesPerSecond << " trades/sec, speedup "
+                  << std::setprecision(2) << singleThreadMs / stats.elapsedMilliseconds << "x, "
+                  << stats.obligations << " obligations, " << stats.selfTrades << " self-trades"
+                  << (matches ? "" : "  RESULT MISMATCH") << std::endl;
+        if (threads * 2 > maxThreads) {
+            std::cout << std::setprecision(1) << "  Projected for 500M trades at this rate: "
+                      << 500e6 / tradesPerSecond / 60.0 << " minutes" << std::endl;
+        }
+    }
+    
+    // Largest net deliveries, to show the shape of the output
+    std::vector<NetObligation> largest = reference;
+    size_t shown = std::min<size_t>(5, largest.size());
+    std::partial_sort(largest.begin(), largest.begin() + shown, largest.end(),
+                      [](const NetObligation& a, const NetObligation& b) {
+                          return std::abs(a.netQuantity) > std::abs(b.netQuantity);
+                      });
+    std::cout << "  Largest net obligations:" << std::endl;
+    for (size_t i = 0; i < shown; ++i) {
+        const auto& o = largest[i];
+        std::cout << "    instrument " << std::setw(2) << o.instrument << " accounts " << std::setw(4)
+                  << o.firstAccount << "/" << std::setw(4) << o.secondAccount << ": net qty " << std::setw(5)
+                  << o.netQuantity << ", net cash " << std::setprecision(2) << std::setw(11) << o.netCash
+                  << ", gross qty " << o.grossQuantity << " in " << o.trades << " trades" << std::endl;
+    }
+}
+
+void runCircuitBreakerBenchmark(size_t numOrders) {
+    std::cout << "\n==== Circuit Breaker Benchmark ====" << std::endl;
+    
+    CircuitBreakerConfig bands;
+    bands.staticBand = 0.05;
+    bands.dynamicBand = 0.02;
+    
+    // A buy sweeps up the ask ladder until a print would leave the bands
+    {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        config.circuitBreakers = bands;
+        MatchingEngine engine(config);
+        engine.start();
+        const OrderBook& book = engine.getOrderBook();
+        
+        for (double price : {100.00, 100.50, 101.00, 101.50, 103.00, 106.00}) {
+            engine.processOrderSync(Order::createOrder(OrderSide::SELL, OrderType::LIMIT, price, 10));
+        }
+        engine.processOrderSync(Order::createOrder(OrderSide::BUY, OrderType::LIMIT, 100.00, 5));
+        auto band = book.getPriceBand();
+        std::cout << "Reference trade at 100.00, bands " << std::fixed << std::setprecision(2)
+                  << band.first << " - " << band.second << std::endl;
+        
+        std::cout << "\nBuy 60 @ 110.00 sweeps the asks:" << std::endl;
+        for (const auto& trade : engine.processOrderSync(Order::createOrder(OrderSide::BUY, OrderType::LIMIT, 110.00, 60))) {
+            std::cout << "  " << trade.toString() << std::endl;
+        }
+        std::cout << "  State: " << (engine.getTradingState(0) == TradingState::AUCTION ? "AUCTION" : "CONTINUOUS")
+                  << ", interruptions: " << book.getInterruptionCount() << std::endl;
+        
+        std::cout << "\nOrders collected during the interruption:" << std::endl;
+        engine.processOrderSync(Order::createOrder(OrderSide::SELL, OrderType::LIMIT, 104.00, 20));
+        engine.processOrderSync(Order::createOrder(OrderSide::BUY, OrderType::LIMIT, 105.00, 15));
+        auto market = Order::createMarketOrder(OrderSide::BUY, 10);
+        engine.processOrderSync(market);
+        std::cout << "  " << book.getBuyOrderCount() << " buy orders, " << book.getSellOrderCount()
+                  << " sell orders resting; market order " << (market->getStatus() == OrderStatus::CANCELED
+                  ? "canceled" : "not canceled") << std::endl;
+        
+        std::cout << "\nResume with a single-price auction:" << std::endl;
+        for (const auto& trade : engine.resumeTrading(0)) {
+            std::cout << "  " << trade.toString() << std::endl;
+        }
+        band = book.getPriceBand();
+        std::cout << "  State: " << (engine.getTradingState(0) == TradingState::AUCTION ? "AUCTION" : "CONTINUOUS")
+                  << ", new bands " << band.first << " - " << band.second << std::endl;
+        engine.stop();
+    }
+    
+    // Orders around a drifting mid price that jumps 8% up or back down every 50000 orders, with the
+    // bands off and on; interruptions end by themselves after 1 ms
+    std::cout << "\n" << numOrders << " orders around a drifting mid price with jumps:" << std::endl;
+    std::mt19937 gen(7);
+    std::normal_distribution<> drift(0.0, 0.002);
+    double mid = 100.0;
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(numOrders);
+    for (size_t i = 0; i < numOrders; ++i) {
+        mid += drift(gen);
+        if (i % 50000 == 49999) {
+            mid *= (i / 50000) % 2 == 0 ? 1.08 : 1 / 1.08;
+        }
+        orders.push_back(Order::createRandomOrder(mid - 0.5, mid + 0.5, 1, 100, 0.2));
+    }
+    for (bool breakers : {false, true}) {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        if (breakers) {
+            config.circuitBreakers = bands;
+            config.circuitBreakers.interruption = std::chrono::milliseconds(1);
+        }
+        MatchingEngine engine(config);
+        
+        std::vector<std::shared_ptr<Order>> copies;
+        copies.reserve(numOrders);
+        for (const auto& order : orders) {
+            copies.push_back(std::make_shared<Order>(order->getId(), order->getSide(), order->getType(),
+                                                     order->getPrice(), order->getQuantity()));
+        }
+        
+        engine.start();
+        PerformanceTimer timer;
+        timer.start();
+        for (const auto& order : copies) {
+            engine.submitOrder(order);
+        }
+        engine.waitForCompletion();
+        timer.stop();
+        
+        std::cout << "  " << (breakers ? "Bands on: " : "Bands off:") << std::fixed << std::setprecision(0)
+                  << " " << numOrders / (timer.elapsedMilliseconds() / 1000.0) << " orders/sec, "
+                  << engine.getStats().totalTradesExecuted.load() << " trades, "
+                  << engine.getOrderBook().getInterruptionCount() << " interruptions" << std::endl;
+        engine.stop();
+    }
+}
+
+void runHaltBenchmark(size_t numOrders) {
+    constexpr size_t kInstruments = 2;
+    constexpr Order::AccountId kAccounts = 8;
+    std::cout << "\n==== Trading Halt Benchmark ====" << std::endl;
+    
+    // Scripted: an instrument halt blocks matching but not cancels, and a kill switch sweeps an account
+    {
+        MatchingEngineConfig config;
+        config.numBooks = kInstruments;
+        config.logTrades = false;
+        config.riskChecks = true;
+        config.numAccounts = kAccounts;
+        MatchingEngine engine(config);
+        engine.start();
+        
+        auto bid = Order::createOrder(OrderSide::BUY, OrderType::LIMIT, 99.00, 10, 1);
+        engine.processOrderSync(bid);
+        engine.processOrderSync(Order::createOrder(OrderSide::SELL, OrderType::LIMIT, 101.00, 10, 1));
+        
+        engine.haltInstrument(1);
+        auto crossing = Order::createOrder(OrderSide::BUY, OrderType::LIMIT, 101.00, 5, 1);
+        size_t trades = engine.processOrderSync(crossing).size();
+        std::cout << "Instrument 1 halted: crossing buy " << (crossing->getStatus() == OrderStatus::REJECTED
+                  ? "rejected" : "accepted") << " with " << trades << " trades, cancel of the resting bid "
+                  << (engine.cancelOrderSync(bid->getId(), 1) ? "accepted" : "refused") << std::endl;
+        
+        engine.resumeInstrument(1);
+        trades = engine.processOrderSync(Order::createOrder(OrderSide::BUY, OrderType::LIMIT, 101.00, 5, 1)).size();
+        std::cout << "Instrument 1 resumed: crossing buy accepted with " << trades << " trades" << std::endl;
+        
+        std::vector<std::shared_ptr<Order>> account7;
+        for (Order::InstrumentId instrument = 0; instrument < kInstruments; ++instrument) {
+            account7.push_back(Order::createOrder(OrderSide::BUY, OrderType::LIMIT, 95.00, 10, instrument, 7));
+            account7.push_back(Order::createOrder(OrderSide::SELL, OrderType::LIMIT, 105.00, 10, instrument, 7));
+            engine.processOrderSync(account7[account7.size() - 2]);
+            engine.processOrderSync(account7.back());
+        }
+        size_t canceled = engine.killAccount(7);
+        for (const auto& order : account7) {
+            if (engine.getOrderBook(order->getInstrument()).findOrder(order->getId())) {
+                throw std::runtime_error("Kill switch left an order of account 7 resting");
+            }
+        }
+        auto late = Order::createOrder(OrderSide::BUY, OrderType::LIMIT, 95.00, 10, 0, 7);
+        engine.processOrderSync(late);
+        std::cout << "Account 7 killed: " << canceled << " resting orders canceled, open notional "
+                  << std::fixed << std::setprecision(2) << engine.getRiskEngine()->getOpenNotional(7)
+                  << ", next order " << (late->getStatus() == OrderStatus::REJECTED ? "rejected" : "accepted")
+                  << std::endl;
+        engine.stop();
+    }
+    
+    std::mt19937 gen(97);
+    std::uniform_int_distribution<Order::InstrumentId> instrumentDist(0, kInstruments - 1);
+    std::uniform_int_distribution<Order::AccountId> accountDist(0, kAccounts - 2);
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(numOrders);
+    for (size_t i = 0; i < numOrders; ++i) {
+        orders.push_back(Order::createRandomOrder(99.0, 101.0, 1, 100, 0.2, instrumentDist(gen), accountDist(gen)));
+    }
+    
+    // Cost of the check over a cache-resident slice, with nothing halted and with an unrelated account halted
+    {
+        std::vector<Order> flat;
+        for (size_t i = 0; i < std::min<size_t>(numOrders, 4096); ++i) {
+            flat.push_back(*orders[i]);
+        }
+        const size_t passes = std::max<size_t>(1, numOrders / flat.size());
+        TradingHalts halts(kInstruments, kAccounts);
+        std::cout << "\nCheck only:" << std::endl;
+        for (bool halted : {false, true}) {
+            halts.setAccountHalted(kAccounts - 1, halted);
+            size_t blocked = 0;
+            PerformanceTimer timer;
+            timer.start();
+            for (size_t pass = 0; pass < passes; ++pass) {
+                for (const Order& order : flat) {
+                    blocked += halts.blocks(order);
+                }
+            }
+            timer.stop();
+            std::cout << std::fixed << std::setprecision(2)
+                      << "  " << (halted ? "Unrelated account halted: " : "Nothing halted:           ")
+                      << timer.elapsedNanoseconds() / static_cast<double>(passes * flat.size())
+                      << " ns per order, " << blocked << " blocked" << std::endl;
+        }
+    }
+    
+    // An admin thread halts instrument 1 a quarter of the way in, kills account 3 halfway and
+    // lifts the instrument halt at three quarters, while the flow keeps coming
+    MatchingEngineConfig config;
+    config.numBooks = kInstruments;
+    config.logTrades = false;
+    config.riskChecks = true;
+    config.numAccounts = kAccounts;
+    config.riskLimits.maxOpenNotional = 1e9;  // A few accounts carry the whole flow
+    MatchingEngine engine(config);
+    engine.start();
+    
+    std::atomic<size_t> submitted{0};
+    size_t canceled = 0;
+    std::thread admin([&engine, &submitted, &canceled, numOrders] {
+        auto waitFor = [&submitted](size_t count) {
+            while (submitted.load(std::memory_order_acquire) < count) {
+                std::this_thread::yield();
+            }
+        };
+        waitFor(numOrders / 4);
+        engine.haltInstrument(1);
+        waitFor(numOrders / 2);
+        canceled = engine.killAccount(3);
+        waitFor(numOrders * 3 / 4);
+        engine.resumeInstrument(1);
+    });
+    
+    std::vector<char> queued(numOrders);
+    PerformanceTimer timer;
+    timer.start();
+    for (size_t i = 0; i < numOrders; ++i) {
+        queued[i] = engine.submitOrder(orders[i]);
+        submitted.fetch_add(1, std::memory_order_release);
+    }
+    engine.waitForCompletion();
+    timer.stop();
+    admin.join();
+    
+    // Only a halt rejects an order after it was queued
+    size_t accepted = 0;
+    size_t rejectedAtBook = 0;
+    size_t account3Resting = 0;
+    for (size_t i = 0; i < numOrders; ++i) {
+        const Order& order = *orders[i];
+        accepted += queued[i];
+        rejectedAtBook += queued[i] && order.getStatus() == OrderStatus::REJECTED;
+        account3Resting += order.getAccount() == 3 &&
+                           engine.getOrderBook(order.getInstrument()).findOrder(order.getId()) != nullptr;
+    }
+    
+    std::cout << "\n" << numOrders << " orders over " << kInstruments << " instruments and " << kAccounts - 1
+              << " accounts with an incident:" << std::endl;
+    std::cout << std::fixed << std::setprecision(0)
+              << "  Throughput: " << numOrders / (timer.elapsedMilliseconds() / 1000.0) << " orders/sec, "
+              << accepted << " accepted, " << engine.getStats().totalTradesExecuted.load() << " trades" << std::endl
+              << "  Blocked by halts: " << engine.getTradingHalts().blockedOrders()
+              << " (" << rejectedAtBook << " of them already queued)"
+              << std::endl
+              << "  Kill switch: " << canceled << " resting orders of account 3 canceled, " << account3Resting
+              << " left resting, open notional " << std::setprecision(2)
+              << engine.getRiskEngine()->getOpenNotional(3) << std::endl;
+    printRiskRejects(*engine.getRiskEngine());
+    engine.stop();
+    
+    // Account 3 is halted from the kill on, so nothing of it may rest, whatever the interleaving
+    if (account3Resting > 0) {
+        throw std::runtime_error("Kill switch left " + std::to_string(account3Resting) +
+                                 " orders of account 3 resting");
+    }
+}
+
+void runCancelLaneBenchmark(size_t numOrders, size_t cancelPriorityRun) {
+    constexpr size_t kQuotes = 1000;
+    constexpr size_t kCancelEvery = 10;
+    std::cout << "\n==== Cancel Priority Lane Benchmark ====" << std::endl;
+    std::cout << "A maker quotes " << kQuotes << " asks, then pulls them one by one inside a burst of "
+              << numOrders << " requests, every " << kCancelEvery << "th a cancel and the rest market buys" << std::endl;
+    
+    for (size_t run : {size_t{0}, cancelPriorityRun}) {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        config.cancelPriorityRun = run;
+        MatchingEngine engine(config);
+        engine.start();
+        
+        // Best quotes first, so the maker pulls the most exposed ones first
+        std::vector<std::shared_ptr<Order>> quotes;
+        for (size_t i = 0; i < kQuotes; ++i) {
+            double price = 100.01 + static_cast<double>(i / 20) * 0.01;
+            quotes.push_back(Order::createOrder(OrderSide::SELL, OrderType::LIMIT, price, 10, 0, 1));
+            engine.processOrderSync(quotes.back());
+        }
+        
+        size_t nextQuote = 0;
+        PerformanceTimer timer;
+        timer.start();
+        for (size_t i = 0; i < numOrders; ++i) {
+            if (i % kCancelEvery == 0 && nextQuote < kQuotes) {
+                engine.submitCancel(quotes[nextQuote++]->getId());
+            } else {
+                engine.submitOrder(Order::createMarketOrder(OrderSide::BUY, 5, 0, 2));
+            }
+        }
+        engine.waitForCompletion();
+        timer.stop();
+        
+        size_t pickedOff = 0;
+        Order::Quantity filled = 0;
+        for (const auto& quote : quotes) {
+            pickedOff += quote->getFilledQuantity() > 0;
+            filled += quote->getFilledQuantity();
+        }
+        const MatchingEngineStats& stats = engine.getStats();
+        std::cout << "\n" << (run == 0 ? "Arrival order:" : "Cancel lane, up to " + std::to_string(run) + " in a row:")
+                  << std::endl;
+        std::cout << std::fixed << std::setprecision(0)
+                  << "  Quotes hit before their cancel: " << pickedOff << " of " << kQuotes
+                  << " (" << filled << " of " << kQuotes * 10 << " shares)" << std::endl
+                  << "  Cancels applied: " << stats.totalCancelsProcessed.load() - stats.totalCancelsMissed.load()
+                  << ", missed: " << stats.totalCancelsMissed.load() << std::endl
+                  << "  Throughput: " << numOrders / (timer.elapsedMilliseconds() / 1000.0) << " requests/sec"
+                  << std::endl;
+        engine.stop();
+    }
+    
+    // The replayer sequences each timestamp's messages with the same rule, so repeated replays agree
+    std::cout << "\nReplaying the ITCH fixture with cancels first, up to " << cancelPriorityRun << " in a row:" << std::endl;
+    for (int pass = 0; pass < 2; ++pass) {
+        MatchingEngineConfig config;
+        config.logTrades = false;
+        MatchingEngine engine(config);
+        engine.start();
+        ItchReader reader(ENGINE_DATA_DIR "/itch50_sample.bin");
+        ItchReplayOptions options;
+        options.cancelPriorityRun = cancelPriorityRun;
+        ItchReplayStats stats = ItchReplayer(engine, options).replay(reader);
+        std::cout << "  Pass " << pass + 1 << ": " << stats.messages << " messages, " << stats.trades << " trades, "
+                  << stats.unknownOrders << " unknown orders, best bid " << std::setprecision(2)
+                  << engine.getOrderBook().getBestBidPrice() << ", " << engine.getOrderBook().getBuyOrderCount()
+                  << " bids and " << engine.getOrderBook().getSellOrderCount() << " asks resting" << std::endl;
+        engine.stop();
+    }
+}
+
+void runCoalescingBenchmark(size_t numOrders) {
+    std::cout << "\n==== Cancel and Amend Coalescing Benchmark ====" << std::endl;
+    std::cout << numOrders << " passive orders sent in one burst; 30% are amended twice and half of those canceled"
+              << std::endl;
+    
+    MatchingEngineConfig config;
+    config.logTrades = false;
+    config.riskChecks = true;
+    config.numAccounts = 1;
+    config.riskLimits.maxOpenNotional = 1e12;
+    MatchingEngine engine(config);
+    engine.start();
+    
+    std::mt19937 gen(99);
+    std::uniform_int_distribution<int> tickDist(0, 99);
+    std::uniform_real_distribution<> choice(0.0, 1.0);
+    std::vector<std::shared_ptr<Order>> orders;
+    std::vector<char> canceled;
+    orders.reserve(numOrders);
+    canceled.reserve(numOrders);
+    size_t requests = 0;
+    
+    PerformanceTimer timer;
+    timer.start();
+    for (size_t i = 0; i < numOrders; ++i) {
+        double price = 99.00 + tickDist(gen) * 0.01;
+        orders.push_back(Order::createOrder(OrderSide::BUY, OrderType::LIMIT, price, 10));
+        engine.submitOrder(orders.back());
+        requests++;
+        
+        double roll = choice(gen);
+        canceled.push_back(roll < 0.15);
+        if (roll < 0.3) {
+            engine.submitReduce(orders.back()->getId(), 2);
+            engine.submitReduce(orders.back()->getId(), 3);
+            requests += 2;
+        }
+        if (canceled.back()) {
+            engine.submitCancel(orders.back()->getId());
+            requests++;
+        }
+    }
+    engine.waitForCompletion();
+    timer.stop();
+    
+    // Every canceled order is gone and the risk engine holds exactly the notional still resting
+    const OrderBook& book = engine.getOrderBook();
+    size_t wrong = 0;
+    double restingNotional = 0.0;
+    for (size_t i = 0; i < numOrders; ++i) {
+        auto resting = book.findOrder(orders[i]->getId());
+        wrong += canceled[i] == (resting != nullptr);
+        if (resting) {
+            restingNotional += resting->getPrice() * static_cast<double>(resting->getRemainingQuantity());
+        }
+    }
+    
+    const MatchingEngineStats& stats = engine.getStats();
+    uint64_t coalesced = stats.totalCancelsCoalesced.load();
+    uint64_t reachedBook = stats.totalOrdersProcessed.load() + stats.totalCancelsProcessed.load() - coalesced;
+    std::cout << std::fixed << std::setprecision(0)
+              << "  Requests: " << requests << ", reached a book: " << reachedBook
+              << ", coalesced in the queue: " << coalesced << std::endl
+              << "  Orders annulled before matching: " << numOrders - stats.totalOrdersProcessed.load()
+              << ", resting: " << book.getBuyOrderCount() << ", in the wrong state: " << wrong << std::endl
+              << "  Open notional " << std::setprecision(2) << engine.getRiskEngine()->getOpenNotional(0)
+              << " against " << restingNotional << " resting" << std::endl
+              << std::setprecision(0)
+              << "  Throughput: " << requests / (timer.elapsedMilliseconds() / 1000.0) << " requests/sec" << std::endl;
+    engine.stop();
+}
+
+// Gateway-style ingress: the same flow submitted one order at a time and in packets
+void runBatchSubmitBenchmark(size_t numOrders, size_t batchSize) {
+    std::cout << "\n==== Batch Submission Benchmark ====" << std::endl;
+    std::cout << "Submitting " << numOrders << " orders from one producer, one at a time and in batches of "
+              << batchSize << std::endl;
+    
+    for (bool pipeline : {false, true}) {
+        std::cout << "\n" << (pipeline ? "Pipeline" : "Worker pool (1 worker)") << ":" << std::endl;
+        for (size_t batch : {size_t{1}, batchSize}) {
+            MatchingEngineConfig config;
+            config.logTrades = false;
+            config.pipeline = pipeline;
+            MatchingEngine engine(config);
+            
+            std::vector<std::shared_ptr<Order>> orders;
+            orders.reserve(numOrders);
+            for (size_t i = 0; i < numOrders; ++i) {
+                orders.push_back(Order::createRandomOrder());
+            }
+            
+            engine.start();
+            PerformanceTimer submitTimer;
+            PerformanceTimer timer;
+            timer.start();
+            submitTimer.start();
+            size_t accepted = 0;
+            if (batch == 1) {
+                for (const auto& order : orders) {
+                    accepted += engine.submitOrder(order);
+                }
+            } else {
+                for (size_t i = 0; i < numOrders; i += batch) {
+                    accepted += engine.submitOrders(orders.data() + i, std::min(batch, numOrders - i));
+                }
+            }
+            submitTimer.stop();
+            engine.waitForCompletion();
+            timer.stop();
+            
+            std::cout << std::fixed << std::setprecision(1)
+                      << "  " << (batch == 1 ? "submitOrder:      " : "submitOrders(" + std::to_string(batch) + "):")
+                      << " " << submitTimer.elapsedMilliseconds() * 1e6 / numOrders << " ns/order to submit, "
+                      << std::setprecision(0) << numOrders / (timer.elapsedMilliseconds() / 1000.0)
+                      << " orders/sec, " << accepted << " accepted, "
+                      << engine.getStats().totalTradesExecuted.load() << " trades" << std::endl;
+            engine.stop();
+        }
+    }
+}
+
+int runCommand(int argc, char* argv[]) {
+    if (std::strcmp(argv[1], "replay") == 0) {
+        std::string path = argc > 2 ? argv[2] : ENGINE_DATA_DIR "/itch50_sample.bin";
+        ReplayPace pace = argc > 3 && std::strcmp(argv[3], "recorded") == 0
+            ? ReplayPace::RECORDED : ReplayPace::MAXIMUM;
+        double speed = argc > 4 ? std::stod(argv[4]) : 1.0;
+        size_t cancelPriorityRun = argc > 5 ? std::stoull(argv[5]) : 0;
+        runItchReplayBenchmark(path, pace, speed, cancelPriorityRun);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "scaling") == 0) {
+        int ordersPerRun = argc > 2 ? std::stoi(argv[2]) : 100000;
+        std::string csvPath = argc > 3 ? argv[3] : "scaling_results.csv";
+        runScalingBenchmark(ordersPerRun, csvPath);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "openloop") == 0) {
+        double startRate = argc > 2 ? std::stod(argv[2]) : 50000.0;
+        double maxRate = argc > 3 ? std::stod(argv[3]) : 2000000.0;
+        double stepMs = argc > 4 ? std::stod(argv[4]) : 200.0;
+        runOpenLoopBenchmark(startRate, maxRate, stepMs);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "memory") == 0) {
+        std::vector<size_t> bookSizes;
+        bool useArenas = true;
+        for (int i = 2; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--no-arena") == 0) {
+                useArenas = false;
+            } else {
+                bookSizes.push_back(std::stoull(argv[i]));
+            }
+        }
+        if (bookSizes.empty()) {
+            bookSizes = {1000000, 10000000, 50000000};
+        }
+        runMemoryBenchmark(bookSizes, useArenas);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "hugepages") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 2000000;
+        size_t numLookups = argc > 3 ? std::stoull(argv[3]) : 2000000;
+        runHugePageBenchmark(numOrders, numLookups);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "warmup") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 5000;
+        HugePageMode hugePages = argc > 3 && std::strcmp(argv[3], "hugepages") == 0
+            ? HugePageMode::TRANSPARENT : HugePageMode::NONE;
+        runWarmUpBenchmark(numOrders, hugePages);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "export") == 0) {
+        size_t numTrades = argc > 2 ? std::stoull(argv[2]) : 1000000;
+        TradeExportFormat format = argc > 3 && std::strcmp(argv[3], "jsonl") == 0
+            ? TradeExportFormat::JSON_LINES : TradeExportFormat::CSV;
+        std::string path = argc > 4 ? argv[4] : "trades_export.out";
+        runExportBenchmark(numTrades, format, path);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "fanout") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 200000;
+        LagPolicy policy = LagPolicy::CONFLATE;
+        if (argc > 3 && std::strcmp(argv[3], "block") == 0) {
+            policy = LagPolicy::BLOCK;
+        } else if (argc > 3 && std::strcmp(argv[3], "disconnect") == 0) {
+            policy = LagPolicy::DISCONNECT;
+        }
+        runFanOutBenchmark(numOrders, policy);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "pipeline") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 500000;
+        std::string journalPath = argc > 3 ? argv[3] : "";
+        runPipelineBenchmark(numOrders, journalPath);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "risk") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 500000;
+        size_t numAccounts = argc > 3 ? std::stoull(argv[3]) : 1024;
+        if (numAccounts == 0) {
+            throw std::invalid_argument("At least one account is needed");
+        }
+        runRiskBenchmark(numOrders, numAccounts);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "positions") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 500000;
+        size_t numAccounts = argc > 3 ? std::stoull(argv[3]) : 256;
+        if (numAccounts == 0) {
+            throw std::invalid_argument("At least one account is needed");
+        }
+        runPositionBenchmark(numOrders, numAccounts);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "netting") == 0) {
+        size_t numTrades = argc > 2 ? std::stoull(argv[2]) : 5000000;
+        size_t maxThreads = argc > 3 ? std::stoull(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+        std::string path = argc > 4 ? argv[4] : "netting_trades.bin";
+        runNettingBenchmark(numTrades, std::max<size_t>(1, maxThreads), path);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "validate") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 1000000;
+        runValidationBenchmark(numOrders);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "ticks") == 0) {
+        size_t numConversions = argc > 2 ? std::stoull(argv[2]) : 10000000;
+        runTickTableBenchmark(numConversions);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "breaker") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 500000;
+        runCircuitBreakerBenchmark(numOrders);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "lanes") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 20000;
+        size_t cancelPriorityRun = argc > 3 ? std::stoull(argv[3]) : 8;
+        runCancelLaneBenchmark(numOrders, cancelPriorityRun);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "coalesce") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 200000;
+        runCoalescingBenchmark(numOrders);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "batch") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 500000;
+        size_t batchSize = argc > 3 ? std::stoull(argv[3]) : 50;
+        if (batchSize == 0) {
+            throw std::invalid_argument("Batch size must be positive");
+        }
+        runBatchSubmitBenchmark(numOrders, batchSize);
+        return 0;
+    }
+    
+    if (std::strcmp(argv[1], "halt") == 0) {
+        size_t numOrders = argc > 2 ? std::stoull(argv[2]) : 500000;
+        runHaltBenchmark(numOrders);
+        return 0;
+    }
+    
+    std::cerr << "Usage: " << argv[0] << " [--counters] [replay [file] [max|recorded] [speed] [cancel run]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [--counters] [scaling [orders per run] [csv file]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [openloop [start rate] [max rate] [ms per step]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [memory [--no-arena] [resting orders ...]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [hugepages [resting orders] [lookups]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [warmup [orders] [hugepages]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [export [trades] [csv|jsonl] [file]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [fanout [orders] [block|conflate|disconnect]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [pipeline [orders] [journal file]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [risk [orders] [accounts]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [positions [orders] [accounts]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [netting [trades] [threads] [trade store file]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [breaker [orders]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [validate [orders]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [ticks [conversions]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [halt [orders]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [lanes [requests] [cancel run]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [coalesce [orders]]" << std::endl;
+    std::cerr << "       " << argv[0] << " [batch [orders] [batch size]]" << std::endl;
+    return 1;
+}
+
 int main(int argc, char* argv[]) {
+    // --counters may appear anywhere and enables hardware performance counters
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--counters") == 0) {
+            PerformanceBenchmark::enableHardwareCounters(true);
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    
+    if (argc > 1) {
+        try {
+            return runCommand(argc, argv);
+        } catch (const std::exception& e) {
+            std::cerr << "ERROR: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
     std::cout << "Concurrent Order Matching Engine Demo" << std::endl;
     std::cout << "====================================" << std::endl;
     
@@ -307,6 +2064,9 @@ int main(int argc, char* argv[]) {
         // Run performance benchmarks
         runPerformanceBenchmark();
         
+        // Replay the bundled ITCH fixture
+        runItchReplayBenchmark(ENGINE_DATA_DIR "/itch50_sample.bin");
+        
     } catch (const std::exception& e) {
         std::cerr << "ERROR: " << e.what() << std::endl;
         return 1;